@@ -0,0 +1,128 @@
+#!/bin/bash
+set -euo pipefail # [Safety] Exit immediately if a command exits with a non-zero status.
+# ------------------------------------------------------------------
+# [Description]
+# Builds an offline benchmark fixture for vcs-gh:
+#   <dir>/remotes/<repo>.git   bare "remote" repos (N commits, M files, K branches)
+#   <dir>/workspace/           empty workspace with .env (URLS/REPO_NAMES) for state_init
+#   <dir>/checkout/            clone of the first repo with .env for the menu flows
+#   <dir>/home/                HOME with git identity set
+#   <dir>/env.sh               source this to use the fixture (HOME, PATH with stub gh)
+#
+# Usage:
+#   bench/make_fixture.sh <dir> [-r repos] [-n commits] [-m files] [-k branches]
+#
+# Example:
+#   bench/make_fixture.sh /tmp/ydjs-bench -r 20 -n 5000 -m 2000 -k 300
+#   source /tmp/ydjs-bench/env.sh && cd "$BENCH_CHECKOUT" && vcs-gh --record push.rec
+# ------------------------------------------------------------------
+BENCH_DIR="${1:-}"
+if [[ -z "$BENCH_DIR" || "$BENCH_DIR" == -* ]]; then
+    echo "Usage: $0 <dir> [-r repos] [-n commits] [-m files] [-k branches]"
+    exit 1
+fi
+shift
+
+REPOS=3
+COMMITS=100
+FILES=50
+BRANCHES=10
+while getopts "r:n:m:k:" opt; do
+    case "$opt" in
+        r) REPOS="$OPTARG";;
+        n) COMMITS="$OPTARG";;
+        m) FILES="$OPTARG";;
+        k) BRANCHES="$OPTARG";;
+        *) echo "Unknown option. Exiting." && exit 1;;
+    esac
+done
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+mkdir -p "$BENCH_DIR"
+BENCH_DIR="$(cd "$BENCH_DIR" && pwd)"
+if [[ -e "$BENCH_DIR/remotes" ]]; then
+    echo "'$BENCH_DIR' already contains a fixture. Remove it first."
+    exit 1
+fi
+mkdir -p "$BENCH_DIR/remotes" "$BENCH_DIR/workspace" "$BENCH_DIR/home"
+
+# ------------------------------------------------------------------
+# Function: fast_import_stream
+# Description:
+#   Prints a git fast-import stream: one commit adding M files, then
+#   N-1 commits each modifying one file, then K branches forked off
+#   main with one extra commit each. Generated by awk so 100k commits
+#   take seconds, not minutes.
+# ------------------------------------------------------------------
+fast_import_stream() {
+    awk -v commits="$COMMITS" -v files="$FILES" -v branches="$BRANCHES" '
+    function commit(ref, mark, parent, msg,    ts) {
+        ts = 1700000000 + mark
+        print "commit " ref
+        print "mark :" mark
+        print "committer Bench <bench@example.com> " ts " +0000"
+        print "data " length(msg)
+        print msg
+        if (parent > 0) print "from :" parent
+    }
+    function modify(path, content) {
+        print "M 100644 inline " path
+        print "data " length(content)
+        print content
+    }
+    BEGIN {
+        commit("refs/heads/main", 1, 0, "initial import")
+        for (f = 0; f < files; f++) modify(sprintf("src/dir%03d/file%05d.txt", f % 100, f), "file " f " rev 0\n")
+        for (c = 2; c <= commits; c++) {
+            commit("refs/heads/main", c, c - 1, "change " c)
+            f = c % files
+            modify(sprintf("src/dir%03d/file%05d.txt", f % 100, f), "file " f " rev " c "\n")
+        }
+        for (b = 1; b <= branches; b++) {
+            commit("refs/heads/feature/bench-" b, commits + b, commits, "branch " b)
+            modify(sprintf("branches/bench-%05d.txt", b), "branch " b "\n")
+        }
+    }'
+}
+
+URLS=""
+REPO_NAMES=""
+for ((i = 1; i <= REPOS; i++)); do
+    name="repo$i"
+    remote="$BENCH_DIR/remotes/$name.git"
+    echo "[$i/$REPOS] Generating $name ($COMMITS commits, $FILES files, $BRANCHES branches)..."
+    git init -q --bare -b main "$remote"
+    fast_import_stream | git -C "$remote" fast-import --quiet
+    git -C "$remote" symbolic-ref HEAD refs/heads/main
+    git -C "$remote" gc -q
+    URLS+="${URLS:+;}file://$remote"
+    REPO_NAMES+="${REPO_NAMES:+;}$name"
+done
+
+# Git identity so state_start() skips the credential menu
+HOME="$BENCH_DIR/home" git config --global user.name "Bench"
+HOME="$BENCH_DIR/home" git config --global user.email "bench@example.com"
+
+cat > "$BENCH_DIR/workspace/.env" <<EOF
+USERNAMES="Bench"
+EMAILS="bench@example.com"
+URLS="$URLS"
+REPO_NAMES="$REPO_NAMES"
+EOF
+
+git clone -q "file://$BENCH_DIR/remotes/repo1.git" "$BENCH_DIR/checkout"
+cp "$BENCH_DIR/workspace/.env" "$BENCH_DIR/checkout/.env"
+echo ".env" >> "$BENCH_DIR/checkout/.git/info/exclude"
+
+cat > "$BENCH_DIR/env.sh" <<EOF
+# Generated by bench/make_fixture.sh - source me
+export BENCH_DIR="$BENCH_DIR"
+export BENCH_WORKSPACE="$BENCH_DIR/workspace"
+export BENCH_CHECKOUT="$BENCH_DIR/checkout"
+export HOME="$BENCH_DIR/home"
+export GH_STUB_LOG="$BENCH_DIR/gh-calls.log"
+export PATH="$SCRIPT_DIR/bin:\$PATH"
+EOF
+
+echo "Fixture ready: $BENCH_DIR"
+echo "  source $BENCH_DIR/env.sh"
@@ -0,0 +1,38 @@
+#!/bin/bash
+set -euo pipefail # [Safety] Exit immediately if a command exits with a non-zero status.
+# ------------------------------------------------------------------
+# [Description]
+# Replays a keystroke recording against a fixture built by
+# make_fixture.sh, fully offline, and prints the replay latency report
+# plus the per-flow child process statistics.
+#
+# Usage:
+#   bench/run_bench.sh <fixture-dir> <recording> [checkout|workspace]
+#
+#   checkout  (default) run inside the cloned repo: push/fetch/commit/delete
+#   workspace run inside the empty workspace: state_init clones
+#
+# The binary is taken from $YDJS_BIN (default: vcs-gh on PATH).
+# ------------------------------------------------------------------
+FIXTURE="${1:-}"
+RECORDING="${2:-}"
+TARGET="${3:-checkout}"
+if [[ -z "$FIXTURE" || -z "$RECORDING" ]]; then
+    echo "Usage: $0 <fixture-dir> <recording> [checkout|workspace]"
+    exit 1
+fi
+RECORDING="$(cd "$(dirname "$RECORDING")" && pwd)/$(basename "$RECORDING")"
+YDJS_BIN="${YDJS_BIN:-vcs-gh}"
+
+# shellcheck source=/dev/null
+source "$FIXTURE/env.sh"
+case "$TARGET" in
+    checkout)  cd "$BENCH_CHECKOUT";;
+    workspace) cd "$BENCH_WORKSPACE";;
+    *)         echo "Unknown target '$TARGET'. Exiting." && exit 1;;
+esac
+
+"$YDJS_BIN" --replay "$RECORDING" --stats
+echo
+echo "Full screen output (including --stats table): $RECORDING.transcript"
+echo "gh calls: $GH_STUB_LOG"
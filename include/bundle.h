@@ -0,0 +1,33 @@
+/* include/bundle.h
+ *
+ * Git bundles as clone seeds.
+ * Export writes '<BUNDLE_DIR>/<repo>.bundle' for every workspace repo (BUNDLE_DIR defaults to
+ * "bundles" in the workspace root, next to the repos, never inside one of them). A bundle holds
+ * origin's branches and the tags only. When a bootstrap finds a bundle for a repo it seeds the
+ * new repository from the local file, adds origin with the real URL and fetches only what the
+ * bundle is missing, so a lab of new machines downloads each repo once, and offline machines
+ * can be pre-seeded by copying files.
+ */
+
+#ifndef BUNDLE_H
+#define BUNDLE_H
+
+#include <stddef.h>
+
+#define BUNDLE_DIR_DEFAULT "bundles"
+
+/* Directory holding the bundles: BUNDLE_DIR from the environment, else BUNDLE_DIR_DEFAULT
+ * under workspace_root(). */
+void bundle_dir(char *dir, size_t size);
+
+/* Writes the bundle path for repo 'name' into 'path'. Returns 1 if that file exists
+ * (0 and "" if the path does not fit). */
+int bundle_path(const char *name, char *path, size_t size);
+
+/* Size in bytes of the bundle for repo 'name', -1 if there is none. */
+long bundle_size(const char *name);
+
+/* Menu action: bundles every cloned workspace repo (origin's branches and tags) concurrently. */
+void bundle_export_action(void);
+
+#endif /* BUNDLE_H */
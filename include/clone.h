@@ -0,0 +1,95 @@
+/* include/clone.h
+ *
+ * Clone profiles for large repositories.
+ * Each repo may opt into a partial (blobless), shallow, single-branch and/or sparse clone,
+ * described by a short option string, e.g. "partial depth=1 sparse=src,docs".
+ * Every new clone also gets the fast paths for later status/add calls: commit-graph,
+ * untracked cache and (where git supports it) the builtin fsmonitor.
+ *
+ * Bootstraps are resumable: a journal file in the workspace records each repo's clone state,
+ * so an interrupted run cleans up the half-written clone and continues where it stopped.
+ */
+
+#ifndef CLONE_H
+#define CLONE_H
+
+#include <stddef.h>
+
+typedef struct {
+    char filter[64];        /* --filter=<spec>, e.g. "blob:none"; "" = full clone */
+    int depth;              /* --depth, 0 = full history */
+    int single_branch;      /* --single-branch */
+    char branch[128];       /* --branch, "" = the remote's default */
+    char sparse[512];       /* sparse-checkout cone paths separated by ','; "" = everything */
+} clone_profile;
+
+/* Parses an option string (tokens separated by spaces):
+ *   default | full          plain clone (same as an empty string)
+ *   partial                 --filter=blob:none
+ *   filter=<spec>           --filter=<spec>
+ *   depth=<n> | shallow     --depth <n> (shallow = 1)
+ *   single-branch           --single-branch
+ *   branch=<name>           --branch <name>
+ *   sparse=<dir>[,<dir>..]  cone-mode sparse checkout of those directories
+ * Returns 0 on success, -1 with a message in 'error' for an unknown or malformed token. */
+int clone_parse_profile(const char *spec, clone_profile *profile, char *error, size_t error_size);
+
+/* One-line summary of the profile for listings, e.g. "partial, depth 1, sparse: src,docs". */
+void clone_describe(const clone_profile *profile, char *buf, size_t size);
+
+/* Restricts the checkout in 'dir' to the profile's sparse paths (cone mode). Returns 0 on success. */
+int clone_set_sparse(const char *dir, const clone_profile *profile);
+
+/* Enables commit-graph, untracked cache and fsmonitor (Windows/macOS) in 'dir'. */
+void clone_enable_fast_paths(const char *dir, const clone_profile *profile);
+
+/* --- Clone journal --- */
+#define CLONE_JOURNAL ".ydjs-clones"
+
+typedef enum {
+    CLONE_PENDING,          /* not started */
+    CLONE_IN_PROGRESS,      /* started; if still set on load, the run was interrupted */
+    CLONE_VERIFIED,         /* cloned and HEAD resolves */
+    CLONE_FAILED            /* gave up after the retries (cleaned up) */
+} clone_state;
+
+typedef struct {
+    char name[256];
+    char url[1024];
+    clone_state state;
+    int attempts;
+    long size_kb;           /* object store size after the last clone, 0 = unknown */
+    double clone_ms;        /* duration of the last clone */
+} journal_entry;
+
+typedef struct {
+    char path[1024];
+    journal_entry *entries;
+    int count;
+} clone_journal;
+
+/* Loads the journal in the current directory (missing file = empty journal). Returns 0 on success. */
+int clone_journal_load(clone_journal *journal);
+void clone_journal_free(clone_journal *journal);
+
+/* Entry for 'name', NULL if the journal has never seen it. */
+const journal_entry *clone_journal_find(const clone_journal *journal, const char *name);
+
+/* 1 if 'dir' is usable: it exists and, unless it was created by someone else, its
+ * journal entry is not an interrupted or failed clone. */
+int clone_is_complete(const clone_journal *journal, const char *dir);
+
+/* Clones every repo that is not complete yet, journaling each step. Clones run concurrently
+ * through the worker pool with a live progress view, ordered by 'priorities' (NULL = all equal,
+ * higher first) and then smallest first, using the sizes journaled by earlier clones, the
+ * bundle sizes, or else the journaled durations at the average rate; each one's git output is logged to
+ * <log dir>/<name>.clone.log. Interrupted clones are removed and redone; transient
+ * network failures are retried CLONE_RETRIES times (default 3) in rounds with exponential
+ * backoff. A full-history clone with a bundle in BUNDLE_DIR is seeded from it and then only
+ * fetches the difference from origin (see bundle.h); if that fails it is redone from origin.
+ * Each new clone gets its sparse paths and fast paths and is tuned (see tune.h).
+ * Returns the failed count. */
+int clone_all(const char **urls, const char **names, const clone_profile *profiles,
+              const int *priorities, int count);
+
+#endif /* CLONE_H */
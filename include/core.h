@@ -33,8 +33,10 @@
     #define GET_CWD(buf, size) _getcwd(buf, size)
     #define CHANGE_DIR(x) _chdir(x)
     #define ACCESS(x) _access(x, 0)
+    #define MAKE_DIR(x) _mkdir(x)
     #define POPEN _popen
     #define PCLOSE _pclose
+    #define NULL_DEVICE "nul"
     
     /* Key Codes for Windows */
     #define KEY_UP 72
@@ -46,13 +48,16 @@
     #include <sys/ioctl.h>
     #include <fcntl.h>
     #include <limits.h>
+    #include <sys/stat.h>
     
     #define SLEEP_MS(x) usleep((x) * 1000)
     #define GET_CWD(buf, size) getcwd(buf, size)
     #define CHANGE_DIR(x) chdir(x)
     #define ACCESS(x) access(x, F_OK)
+    #define MAKE_DIR(x) mkdir(x, 0755)
     #define POPEN popen
     #define PCLOSE pclose
+    #define NULL_DEVICE "/dev/null"
     
     /* Key Codes for Linux/Mac */
     #define KEY_UP 65
@@ -69,6 +74,12 @@ void disable_raw_mode(void);
 /* --- SCREEN CONTROL --- */
 void clear_screen(void);
 
+/* Height of the terminal in rows (24 if unknown). */
+int terminal_rows(void);
+
+/* Width of the terminal in columns (80 if unknown). */
+int terminal_cols(void);
+
 /* --- USER INPUT --- */
 /* Pauses execution until user presses any key. Displays "Press any key to continue...".
  * Accepts printf-style format string and variadic arguments for consistency (optional).
@@ -84,9 +95,68 @@ void get_input_string(char *buffer, int size);
 int get_key(void);
 
 /* --- SYSTEM COMMANDS --- */
-/* Executes a system command. Returns 0 on success. */
+/* Executes a system command. Returns 0 on success.
+ * The child's wall time, CPU, peak RSS and block I/O are reported to the stats module.
+ */
 int run_cmd(const char *fmt, ...);
 
+/* popen() replacement with the same accounting as run_cmd().
+ * mode is "r" (read the command's stdout) or "w" (write its stdin).
+ * Must be closed with close_cmd(), which returns the command's exit code (0 on success).
+ */
+FILE *open_cmd(const char *mode, const char *fmt, ...);
+int close_cmd(FILE *fp);
+
+/* Runs a command and keeps the first line of its stdout in 'buf'.
+ * Returns 1 if it succeeded and printed something, 0 otherwise. */
+int read_cmd_line(char *buf, size_t size, const char *fmt, ...);
+
+#ifndef _WIN32
+/* Low-level building blocks of run_cmd()/open_cmd() for callers that manage children themselves.
+ * spawn_shell() forks '/bin/sh -c command' in 'cwd' (NULL = current directory); fds >= 0 replace
+ * the child's stdin/stdout/stderr. reap_child() waits with wait4(), reports the usage to the
+ * stats module and returns the raw wait status.
+ */
+pid_t spawn_shell(const char *cwd, const char *command, int child_in, int child_out, int child_err);
+int reap_child(pid_t pid, const char *command, double start_ms);
+#endif
+
+/* --- BACKGROUND COMMANDS --- */
+/* A shell command running while the UI stays responsive. Its stdin/stdout/stderr go to the
+ * null device and git is told never to prompt, so it cannot draw over menus. 'nice_level'
+ * lowers its CPU/IO priority. On Windows bg_start() runs the command to completion instead.
+ */
+typedef struct {
+    int running;            /* started and not reaped yet */
+    int exit_code;          /* valid once running == 0 */
+#ifndef _WIN32
+    pid_t pid;
+#endif
+    double start_ms;
+    char command[1024];
+} bg_cmd;
+
+/* Returns 0 if the command was started. */
+int bg_start(bg_cmd *job, int nice_level, const char *fmt, ...);
+
+/* Non-blocking check: reaps the command if it exited. Returns 1 once it is done. */
+int bg_done(bg_cmd *job);
+
+/* Waits for the command and returns its exit code (-1 if it never started). */
+int bg_join(bg_cmd *job);
+
+/* --- TIMING --- */
+/* Monotonic clock in milliseconds (arbitrary origin). */
+double now_ms(void);
+
+/* --- SYSTEM INFO --- */
+/* Number of online CPUs (at least 1). */
+int cpu_count(void);
+
+/* Absolute, normalised form of 'path' ('..' and symlinks resolved); it must exist.
+ * Returns 0 on success, -1 if it cannot be resolved or does not fit. */
+int absolute_path(const char *path, char *out, size_t size);
+
 /* --- FANCY OUTPUT --- */
 /* Prints a message with increasing dots (., .., ...) every 0.5 seconds.
  * Has the same signature as printf - accepts format string and variadic arguments.
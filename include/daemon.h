@@ -0,0 +1,34 @@
+/* include/daemon.h
+ *
+ * Optional per-user daemon keeping warm state between invocations.
+ * 'vcs-gh --daemon' detaches a server on a Unix domain socket ($XDG_RUNTIME_DIR/ydjs.sock,
+ * else /tmp/ydjs-<uid>.sock, mode 0600) that caches what every start otherwise pays processes for:
+ *   PING            -> OK <pid>
+ *   TOOLS           -> OK <git 0/1> <gh 0/1>       (probed once; a missing tool is probed again)
+ *   CONFIG [key]    -> OK <value> | NO             (global git config; no key = the whole listing)
+ *   STOP            -> OK
+ * Both ends check the peer's uid (SO_PEERCRED / getpeereid) and drop connections from any other
+ * user. The config is re-read when the global config file changes. The daemon exits after
+ * DAEMON_IDLE seconds (default 1800) without a request. It inherits the environment of whoever
+ * started it; restart it after changing PATH. Without a daemon (or on Windows) every query
+ * fails fast and callers do the work themselves.
+ */
+
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <stddef.h>
+
+#define DAEMON_IDLE_DEFAULT 1800
+
+/* --daemon: starts the server in the background. Returns 0 if it runs (or already ran). */
+int daemon_start(void);
+
+/* --daemon-stop: asks a running server to exit. Returns 0 if one answered. */
+int daemon_stop(void);
+
+/* Sends one request line and stores the reply text after "OK " in 'reply'.
+ * Returns 0 on OK, 1 on NO, -1 if no daemon answered. */
+int daemon_query(const char *request, char *reply, size_t size);
+
+#endif /* DAEMON_H */
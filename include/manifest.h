@@ -0,0 +1,81 @@
+/* include/manifest.h
+ *
+ * Workspace manifest: one record per repository.
+ * MANIFEST_FILE in the workspace holds one line per repo ('#' starts a comment):
+ *   <path> <url> [branch=<name>] [group=<name>] [priority=<n>] [clone options...]
+ * e.g.
+ *   app    https://example.com/app.git  branch=develop group=core priority=10 partial
+ *   docs   https://example.com/docs.git group=web depth=1 sparse=guides,api
+ * Clone options are the tokens of clone_parse_profile(). Higher priorities are cloned first
+ * (default 0); within a priority the smaller repos go first. Without a manifest file the table
+ * is built from the legacy URLS / REPO_NAMES / CLONE_OPTIONS arrays in .env.
+ *
+ * The file is parsed once into a compact table whose strings all live in one buffer.
+ * After a sync the applied records are written to MANIFEST_APPLIED (same syntax), so the
+ * next sync only acts on entries that were added or changed since.
+ */
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include "clone.h"
+#include <stddef.h>
+
+#define MANIFEST_FILE    "ydjs.manifest"
+#define MANIFEST_APPLIED ".ydjs-manifest.applied"
+
+typedef struct {
+    const char *path;       /* directory, relative to the workspace */
+    const char *url;
+    const char *branch;     /* "" = the remote's default */
+    const char *group;      /* "" = none */
+    const char *options;    /* clone options, "" = plain clone */
+    int priority;           /* clone order, higher first; 0 = default */
+    int line;               /* source line, 0 for .env entries */
+} manifest_entry;
+
+typedef struct {
+    manifest_entry *entries;
+    int count;
+    char *text;             /* backing store of every string above */
+} manifest;
+
+/* Loads MANIFEST_FILE, or the .env arrays when there is none. Returns 0 on success, -1 with a
+ * message in 'error' (missing definition, count mismatch, bad line, duplicate path). */
+int manifest_load(manifest *m, char *error, size_t error_size);
+
+/* Loads a manifest file. Returns 0 on success, 1 if it does not exist, -1 on a parse error. */
+int manifest_load_file(manifest *m, const char *file, char *error, size_t error_size);
+
+void manifest_free(manifest *m);
+
+/* Entry with 'path', NULL if none. */
+const manifest_entry *manifest_find(const manifest *m, const char *path);
+
+/* Clone profile of the entry: its options plus its branch. Entries are validated on load,
+ * so this only fails for tables built by hand. Returns 0 on success. */
+int manifest_profile(const manifest_entry *entry, clone_profile *profile);
+
+/* 1 if the entry belongs to one of the comma-separated 'groups' (NULL/"" = every entry). */
+int manifest_in_groups(const manifest_entry *entry, const char *groups);
+
+/* --- Incremental sync --- */
+#define MANIFEST_NEW      1     /* not applied before */
+#define MANIFEST_URL      2
+#define MANIFEST_BRANCH   4
+#define MANIFEST_OPTIONS  8
+
+/* What changed in each entry since the applied manifest: changes[i] is a mask of
+ * MANIFEST_* bits, 0 = unchanged. 'applied' may be empty (then every entry is new). */
+void manifest_diff(const manifest *m, const manifest *applied, int *changes);
+
+/* Writes MANIFEST_APPLIED: entries with applied_ok[i] set as they are now, the others as they
+ * were in 'applied' (if at all), so a failed change shows up again next time. Returns 0 on success. */
+int manifest_save_applied(const manifest *m, const manifest *applied, const char *applied_ok);
+
+/* Brings an existing clone in line with a changed entry ('old' = its applied record, may be
+ * NULL): sets the origin URL, switches to the branch and re-applies sparse paths. Other clone
+ * options only affect new clones and are reported. Returns 0 on success. */
+int manifest_update_repo(const manifest_entry *entry, const manifest_entry *old, int changes);
+
+#endif /* MANIFEST_H */
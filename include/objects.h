@@ -0,0 +1,52 @@
+/* include/objects.h
+ *
+ * Object queries through a long-running 'git cat-file --batch' coprocess.
+ * One child per repository is started on first use and kept until objects_close(), so asking
+ * about hundreds of branch tips costs one process instead of one per object. Requests are
+ * pipelined: a window of names is written before the answers are read. A coprocess that dies
+ * is restarted and the unanswered part of the batch re-sent. Refs themselves are read
+ * in-process (refs.h); this is for objects.
+ */
+
+#ifndef OBJECTS_H
+#define OBJECTS_H
+
+#include "refs.h"
+#include <stddef.h>
+#include <stdio.h>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+#define OBJECT_SUBJECT_MAX 128
+
+/* One coprocess ('git cat-file --batch' in 'dir') */
+typedef struct {
+#ifndef _WIN32
+    pid_t pid;                  /* 0 = not running */
+    int in;                     /* its stdin */
+    FILE *out;                  /* its stdout */
+    double start_ms;
+#endif
+    int restarts;
+} cat_file;
+
+typedef struct {
+    char dir[1024];             /* repository, "" = current directory */
+    cat_file batch;
+} object_db;
+
+/* Prepares queries against the repository in 'dir' (NULL = current directory).
+ * No process is started until the first query. */
+void objects_open(object_db *db, const char *dir);
+
+/* Stops the coprocess. */
+void objects_close(object_db *db);
+
+/* First line of the message of each name (oid or rev, e.g. "refs/heads/main") that is a commit
+ * or tag; "" if the object is missing or has none.
+ * Returns 0 on success, -1 if git could not answer. */
+int objects_subjects(object_db *db, const char *const *names, int count, char (*subjects)[OBJECT_SUBJECT_MAX]);
+
+#endif /* OBJECTS_H */
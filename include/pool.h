@@ -0,0 +1,48 @@
+/* include/pool.h
+ *
+ * Bounded worker pool for running many shell commands concurrently.
+ * Each job runs '/bin/sh -c command' in its own working directory with stdout and stderr
+ * captured; at most 'max_workers' jobs run at the same time. On Windows jobs run one by one.
+ * An optional observer sees every chunk of output as it arrives (e.g. for a live progress view),
+ * and each job's full output can be written to its own log file.
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+typedef struct {
+    /* Input */
+    char label[256];        /* row name in summaries (e.g. repo name) */
+    char cwd[1024];         /* working directory, "" = current directory */
+    char command[2048];     /* shell command */
+    char log_path[1024];    /* "" = no log file; else receives the complete output */
+
+    /* Result */
+    int exit_code;          /* exit code, -1 if the job could not be started */
+    double wall_ms;         /* wall-clock duration */
+    char *output;           /* captured stdout+stderr (NUL-terminated, may be NULL) */
+    size_t output_len;
+    int started;            /* 1 once the job was launched */
+    int finished;           /* 1 once it exited (exit_code/wall_ms are then final) */
+} pool_job;
+
+/* Called with index >= 0 and the new bytes whenever job 'index' produced output, and with
+ * index == -1 (data NULL) on a timer tick and whenever a job starts or finishes. */
+typedef void (*pool_observer)(const pool_job *jobs, int count, int index,
+                              const char *data, size_t n, void *ctx);
+
+/* Worker count: PARALLEL_JOBS from the environment, else the number of online CPUs (max 16). */
+int pool_default_workers(void);
+
+/* Runs all jobs, at most max_workers at a time. Returns the number of jobs with exit_code != 0. */
+int pool_run(pool_job *jobs, int count, int max_workers);
+
+/* pool_run() that reports to 'observer' (NULL = none). */
+int pool_run_observed(pool_job *jobs, int count, int max_workers, pool_observer observer, void *ctx);
+
+/* Frees the captured output of every job (not the array itself). */
+void pool_free(pool_job *jobs, int count);
+
+#endif /* POOL_H */
@@ -0,0 +1,49 @@
+/* include/prestage.h
+ *
+ * Pre-stage scan: finds what 'git add .' is about to pull in that probably should not be
+ * committed, before it is staged.
+ * The candidates are git's own list of modified and untracked, not ignored files; they are
+ * checked by a pool of threads for
+ *   - size above PRESTAGE_MAX_MB (default 50 MiB), and
+ *   - binary content (a NUL byte in the first 8000 bytes, git's own test),
+ * and hits tracked by Git LFS (filter=lfs) are dropped. The caller lets the user exclude hits;
+ * staging then runs with those paths excluded. PRESTAGE=0 skips the scan.
+ */
+
+#ifndef PRESTAGE_H
+#define PRESTAGE_H
+
+#include <stddef.h>
+
+#define PRESTAGE_MAX_MB_DEFAULT 50
+
+#define PRESTAGE_LARGE  1
+#define PRESTAGE_BINARY 2
+
+typedef struct {
+    const char *path;           /* relative to the current directory, points into the report */
+    long long size;
+    int reasons;                /* PRESTAGE_* bits */
+} prestage_hit;
+
+typedef struct {
+    prestage_hit *hits;
+    int count;
+    int scanned;                /* candidates looked at */
+    double scan_ms;
+    char *paths;                /* backing store of every path */
+} prestage_report;
+
+/* Scans the candidates of the repository in the current directory.
+ * Returns the number of hits, -1 if git could not list the candidates. */
+int prestage_scan(prestage_report *report);
+
+void prestage_free(prestage_report *report);
+
+/* Writes the staging command into 'command': 'git add .' when nothing is excluded, else a
+ * 'git add' that leaves out every hit with excluded[i] set (its pathspecs go to a file in the
+ * git dir). Returns 0 on success, -1 if that file could not be written or the command does
+ * not fit. */
+int prestage_command(const prestage_report *report, const char *excluded, char *command, size_t size);
+
+#endif /* PRESTAGE_H */
@@ -0,0 +1,54 @@
+/* include/progress.h
+ *
+ * Live progress view for concurrent git jobs run through the pool.
+ * Each job's output is scanned for git's progress lines, e.g.
+ *   Receiving objects:  45% (450/1000), 1.20 MiB | 2.00 MiB/s
+ * and the view redraws one status row per running job plus an overall line with an ETA.
+ * The full output of every job goes to a log file (see progress_log_path()).
+ */
+
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include "pool.h"
+#include <stddef.h>
+
+#define PROGRESS_LOG_DIR "ydjs-logs"
+
+typedef struct {
+    char phase[32];         /* e.g. "Receiving objects"; "" until git reports one */
+    int percent;            /* of the phase */
+    char transfer[64];      /* e.g. "1.20 MiB | 2.00 MiB/s"; "" if not reported */
+    char partial[256];      /* unterminated line carried over to the next chunk */
+    size_t partial_len;
+} progress_row;
+
+typedef struct {
+    const char *title;      /* e.g. "Cloning" */
+    progress_row *rows;     /* one per job */
+    int count;
+    double start_ms;
+    double drawn_ms;        /* time of the last redraw */
+    int drawn_lines;        /* lines of the last redraw, overwritten by the next one */
+} progress_view;
+
+/* Returns 0 on success, -1 if out of memory. Free with progress_free(). */
+int progress_init(progress_view *view, const char *title, int count);
+void progress_free(progress_view *view);
+
+/* pool_observer for pool_run_observed(); 'ctx' is the progress_view. */
+void progress_observe(const pool_job *jobs, int count, int index, const char *data, size_t n, void *ctx);
+
+/* Replaces the live rows with a final "<title>: N done, M failed in Xs" line. */
+void progress_finish(progress_view *view, const pool_job *jobs, int count);
+
+/* Where the logs go: '<git dir>/<PROGRESS_LOG_DIR>' inside a repository, else
+ * '.<PROGRESS_LOG_DIR>' in the current directory (the workspace root), so they are never
+ * picked up by 'git add .'. Returns 0 on success, -1 if the path does not fit. */
+int progress_log_dir(char *dir, size_t size);
+
+/* "<log dir>/<label>.<kind>.log", creating the directory. Returns 0 on success,
+ * -1 if the directory cannot be created or the path does not fit ('path' is then ""). */
+int progress_log_path(const char *label, const char *kind, char *path, size_t size);
+
+#endif /* PROGRESS_H */
@@ -0,0 +1,98 @@
+/* include/refs.h
+ *
+ * In-process access to git refs.
+ * Reads loose refs and packed-refs straight from the repository so listing branches does
+ * not cost a git process, and deletes branches in one 'git update-ref --stdin' transaction.
+ */
+
+#ifndef REFS_H
+#define REFS_H
+
+#include <stddef.h>
+
+#define REF_NAME_MAX 256
+#define REF_OID_MAX  65     /* SHA-256 hex + NUL */
+
+typedef struct {
+    char name[REF_NAME_MAX];    /* full ref name, e.g. "refs/heads/main" */
+    char oid[REF_OID_MAX];
+} ref_entry;
+
+typedef struct {
+    ref_entry *items;           /* sorted by name */
+    int count;
+    int capacity;
+} ref_list;
+
+/* Read-only view of packed-refs plus the loose refs under one prefix.
+ * packed-refs is mapped into memory and binary-searched in place, so opening the index
+ * costs only the loose refs under 'prefix' and a lookup is O(log n) however many refs
+ * are packed. Files written without the 'sorted' trait are parsed and sorted instead. */
+typedef struct {
+    char *data;                 /* packed-refs contents (NULL if there is none) */
+    size_t size;
+    size_t body;                /* offset of the first record, after the header line */
+    int mapped;                 /* data is an mmap (else heap) */
+    ref_list unsorted;          /* packed refs parsed and sorted, when the file is not (data is then NULL) */
+    ref_list loose;             /* loose refs under 'prefix', sorted */
+    char prefix[REF_NAME_MAX];
+} ref_index;
+
+/* Resolves the repository's git dir (handles '.git' files of worktrees/submodules)
+ * and the common dir holding the shared refs. Return 1 on success, 0 if not in a repo. */
+int refs_git_dir(char *buf, size_t size);
+int refs_common_dir(char *buf, size_t size);
+
+/* Lists every ref under 'prefix' (e.g. "refs/heads/"), loose refs overriding packed ones.
+ * Returns the count (list->items sorted by name), -1 on error. Free with refs_free(). */
+int refs_list(const char *prefix, ref_list *list);
+void refs_free(ref_list *list);
+
+/* Opens the index for refs under 'prefix', a directory ("refs/remotes/origin/") or a name prefix
+ * ("refs/heads/_cache_"). Returns 0 on success, -1 if not in a repository or out of memory.
+ * Always pair with ref_index_close(). */
+int ref_index_open(ref_index *index, const char *prefix);
+void ref_index_close(ref_index *index);
+
+/* Looks up a full ref name under the index prefix; a loose ref wins over a packed one.
+ * Copies its oid into 'oid' and returns 1, or returns 0 if the ref does not exist. */
+int ref_index_lookup(const ref_index *index, const char *name, char *oid, size_t size);
+
+/* Appends every ref under the index prefix to 'list' in sorted order. Returns the count, -1 on error. */
+int ref_index_list(const ref_index *index, ref_list *list);
+
+/* List building blocks for other ref sources (e.g. ls-remote). refs_add() returns -1 on
+ * allocation failure; refs_find() needs a sorted list (refs_sort()). */
+int refs_add(ref_list *list, const char *name, const char *oid);
+void refs_sort(ref_list *list);
+const ref_entry *refs_find(const ref_list *list, const char *name);
+
+/* Current branch name from HEAD (without "refs/heads/"). Returns 0 if HEAD is detached. */
+int refs_head_branch(char *buf, size_t size);
+
+/* Default branch of 'remote' (e.g. "main") from refs/remotes/<remote>/HEAD, falling back to
+ * main/master when the symref is missing. Returns 0 if none is known. */
+int refs_remote_default_branch(const char *remote, char *buf, size_t size);
+
+/* Branches checked out in the main worktree and every linked one ('git worktree add'), as a
+ * sorted list of "refs/heads/<branch>" names (oids left empty). Returns the count, -1 on error. */
+int refs_worktree_heads(ref_list *list);
+
+/* Directory of the worktree that has 'branch' checked out. Returns 1 if there is one. */
+int refs_worktree_path(const char *branch, char *path, size_t size);
+
+/* Deletes every local branch except HEAD's branch, the branches checked out in other
+ * worktrees and those whose name contains one of the 'keep' patterns, in a single
+ * update-ref transaction. Also drops their [branch "..."] config sections. Returns the number deleted, -1 on failure. */
+int refs_prune_branches(const char *keep[], int keep_count);
+
+/* Deletes the refs of 'list' whose 'flags' entry is set, in one update-ref transaction that
+ * checks each old oid. Returns the number deleted, -1 if it failed (then nothing was deleted). */
+int refs_delete_flagged(const ref_list *list, const char *flags);
+
+/* Deletes the refs/remotes/<remote>/ entries whose branch is not in 'live_heads' (sorted
+ * refs/heads/... list, e.g. from ls-remote): a local 'fetch --prune' without the fetch.
+ * Returns the number deleted, -1 on failure. */
+int refs_prune_remote(const char *remote, const ref_list *live_heads);
+
+#endif /* REFS_H */
@@ -0,0 +1,56 @@
+/* include/remote.h
+ *
+ * Remote queries that avoid downloading objects.
+ * Branch listings come from 'git ls-remote', which only exchanges the ref advertisement;
+ * objects are fetched later for the one branch the user actually needs.
+ */
+
+#ifndef REMOTE_H
+#define REMOTE_H
+
+#include "refs.h"
+
+/* Lists the heads of 'remote' in one 'git ls-remote --symref' round trip, parsed line by line.
+ * 'pattern' (NULL/"" = all) is a glob on branch names, e.g. "release-*".
+ * Fills 'heads' with sorted "refs/heads/..." entries and, if non-NULL, 'default_branch'
+ * with the remote's HEAD branch ("" if unknown). Returns the count, -1 if ls-remote failed. */
+int remote_list_heads(const char *remote, const char *pattern, ref_list *heads,
+                      char *default_branch, size_t default_size);
+
+/* Fetches exactly one branch into refs/remotes/<remote>/<branch>. Returns 0 on success. */
+int remote_fetch_branch(const char *remote, const char *branch);
+
+/* Outcomes of remote_sync_branch() */
+#define REMOTE_CURRENT    0     /* tracking ref already at the advertised oid */
+#define REMOTE_PREFETCHED 1     /* objects were prefetched; the tracking ref was moved locally */
+#define REMOTE_FETCHED    2     /* fetched over the network */
+
+/* Brings refs/remotes/<remote>/<branch> to 'oid' (as advertised by ls-remote) the cheapest way.
+ * Returns one of the REMOTE_* outcomes, or -1 if the fetch failed. */
+int remote_sync_branch(const char *remote, const char *branch, const char *oid);
+
+/* --- Fetch freshness ---
+ * A full fetch of <remote> stamps <git dir>/ydjs-fetched-<remote> with the time. Within
+ * FETCH_FRESHNESS seconds of the stamp (default 300, 0 = always fetch) a fetch is first reduced
+ * to an 'ls-remote --heads' tip comparison and skipped if nothing moved.
+ * Like the refs helpers these work on the repository in the current directory. */
+int remote_freshness_window(void);
+
+/* Seconds since the last recorded full fetch of 'remote', -1 if there is none. */
+double remote_fetch_age(const char *remote);
+void remote_mark_fetched(const char *remote);
+
+/* 1 if the "<oid><TAB>refs/heads/<branch>" lines in 'ls_remote_output' match the
+ * refs/remotes/<remote>/ tracking refs exactly (same branches, same oids). */
+int remote_tips_match(const char *remote, const char *ls_remote_output);
+
+/* --- Background prefetch ---
+ * 'git fetch --prefetch' downloads every branch into the hidden refs/prefetch/remotes/<remote>/
+ * namespace, leaving the user's tracking refs alone, at the lowest CPU/IO priority.
+ * remote_prefetch_start() is called while a menu waits for input: it starts a prefetch unless
+ * one is running or the last one began less than PREFETCH_INTERVAL seconds ago (default 300,
+ * 0 disables). Flows that need the remote join it first so both never race. POSIX only. */
+void remote_prefetch_start(const char *remote);
+void remote_prefetch_join(void);
+
+#endif /* REMOTE_H */
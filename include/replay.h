@@ -0,0 +1,34 @@
+/* include/replay.h
+ *
+ * Keystroke record/replay harness for headless UI benchmarks.
+ * --record FILE: every input read by get_key()/get_input_string()/pausef() is appended to FILE
+ *                with a timestamp.
+ * --replay FILE: runs the tool on a pseudo-terminal, feeds the recorded input back at full
+ *                speed and reports keypress-to-frame latency percentiles of show_menu().
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stddef.h>
+
+/* Input event kinds (one per blocking read in core.c) */
+#define INPUT_KEY   'k'     /* get_key(): one key, possibly an escape sequence */
+#define INPUT_LINE  'l'     /* get_input_string(): one line including '\n' */
+#define INPUT_PAUSE 'p'     /* pausef(): any key */
+
+/* Starts recording to 'path' (truncates). Returns 0 on success. */
+int input_record_start(const char *path);
+
+/* Called by core.c right before blocking for input of 'kind'.
+ * Flushes stdout and, under --replay, tells the driver the frame is complete. */
+void input_wait(char kind);
+
+/* Called by core.c with the bytes an input read of 'kind' consumed. */
+void input_record(char kind, const char *bytes, size_t n);
+
+/* Replays 'path' against a fresh instance of this program (argv minus --replay/--record).
+ * Returns the process exit code. POSIX only. */
+int replay_run(const char *path, int argc, char *argv[]);
+
+#endif /* REPLAY_H */
@@ -0,0 +1,25 @@
+/* include/snapshot.h
+ *
+ * Working-tree snapshots that never touch the checkout.
+ * The tree is staged into a temporary index and committed with write-tree/commit-tree onto a
+ * new '_cache_<timestamp>' branch, so the user's index, HEAD and files stay as they were.
+ * Snapshots form a bounded ring: the oldest ones expire automatically.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+
+#define SNAPSHOT_PREFIX "_cache_"
+
+/* Saves tracked and untracked files (.gitignore respected) as a commit on top of HEAD and
+ * stores the new branch name in 'name', then expires old snapshots.
+ * Returns 1 if a snapshot was saved, 0 if the working tree matches HEAD, -1 on error. */
+int snapshot_save(char *name, size_t size);
+
+/* Keeps the newest CACHE_SNAPSHOTS snapshots (default 5) and drops those older than
+ * CACHE_EXPIRE_DAYS days (default 14, 0 = no age limit). Returns the number deleted. */
+int snapshot_expire(void);
+
+#endif /* SNAPSHOT_H */
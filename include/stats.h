@@ -0,0 +1,34 @@
+/* include/stats.h
+ *
+ * Per-child resource accounting.
+ * Every command launched through run_cmd()/open_cmd() reports its cost here; costs are
+ * aggregated per flow (push, fetch, commit, delete, clone, ...) and per command.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+/* Resource usage of one finished child process. */
+typedef struct {
+    double wall_ms;     /* wall-clock time from spawn to reap */
+    double user_ms;     /* user CPU time */
+    double sys_ms;      /* system CPU time */
+    long   max_rss_kb;  /* peak resident set size */
+    long   in_blocks;   /* block input operations */
+    long   out_blocks;  /* block output operations */
+} proc_usage;
+
+/* Enables the summary printed by stats_print_summary() (set by --stats). */
+void stats_enable(void);
+int stats_enabled(void);
+
+/* Attributes every following child to 'flow' (e.g. "push"). */
+void stats_set_flow(const char *flow);
+
+/* Records one finished child. 'command' is the full command line. */
+void stats_record(const char *command, const proc_usage *usage);
+
+/* Prints the per-flow / per-command table collected so far. */
+void stats_print_summary(void);
+
+#endif /* STATS_H */
@@ -0,0 +1,36 @@
+/* include/status.h
+ *
+ * Working-tree status panel for the main menu header.
+ * Fed by 'git status --porcelain=v2 -z --branch', parsed record by record as it streams in,
+ * so only counters and the first few paths are ever held in memory. The scan is repeated only
+ * when the index, HEAD or the checked-out branch's ref file changed since the last one; git
+ * rewrites the index on every add, commit, checkout and reset. Edits made to files while the
+ * menu is open show up after the next such change. STATUS_PANEL=0 turns the panel off.
+ */
+
+#ifndef STATUS_H
+#define STATUS_H
+
+#define STATUS_PANEL_PATHS 5    /* paths listed under the counters */
+
+typedef struct {
+    char branch[256];           /* "(detached)" when HEAD is detached */
+    char upstream[256];         /* "" if none */
+    int ahead, behind;
+    int staged, modified, untracked, conflicted;
+    char paths[STATUS_PANEL_PATHS][256];   /* "XY path" of the first changes */
+    int path_count;
+    int entries;                /* changed paths in total */
+    double scan_ms;             /* cost of the last scan */
+    char stamp[512];            /* index/HEAD identity at the last scan, "" = never scanned */
+} status_panel;
+
+/* Rescans if the repository changed since the last call. Returns 1 if it scanned,
+ * 0 if the panel was still current, -1 if the current directory is not a repository. */
+int status_panel_refresh(status_panel *panel);
+
+/* Prints the panel: branch and upstream line, counters, then up to STATUS_PANEL_PATHS paths.
+ * Returns the number of lines printed. */
+int status_panel_print(const status_panel *panel);
+
+#endif /* STATUS_H */
@@ -0,0 +1,21 @@
+/* include/tune.h
+ *
+ * Machine-aware git performance profile for managed repositories.
+ * Sizes git's own parallelism from the core count, the filesystem the repository lives on
+ * (network filesystems benefit from more checkout workers) and the number of tracked files:
+ *   checkout.workers, index.threads, pack.threads, fetch.parallel, feature.manyFiles
+ * All settings are repo-local; the user's global config is never touched.
+ */
+
+#ifndef TUNE_H
+#define TUNE_H
+
+/* Applies the profile to the repository in 'dir'. With 'measure' set, also times
+ * 'git status' and a full checkout (into a scratch directory) before and after and
+ * prints the comparison. Returns 0 on success, -1 if 'dir' is not a repository. */
+int tune_repo(const char *dir, int measure);
+
+/* Menu action: tunes every existing repo in REPO_NAMES (or the current one) with timings. */
+void tune_action(void);
+
+#endif /* TUNE_H */
@@ -0,0 +1,38 @@
+/* include/workspace.h
+ *
+ * Multi-repo operations over every repository of the workspace manifest (see manifest.h),
+ * optionally narrowed to the comma-separated groups in WORKSPACE_GROUPS.
+ * Repositories are resolved against WORKSPACE_DIR (default: the current directory, falling
+ * back to its parent so the actions also work from inside one of the sibling repos).
+ * Work is fanned out over the bounded worker pool and collected into one summary table.
+ */
+
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <stddef.h>
+
+typedef struct {
+    char name[256];     /* manifest path */
+    char path[1024];    /* resolved directory */
+    int exists;         /* 1 if 'path' exists */
+} ws_repo;
+
+/* Loads the manifest entries into a newly allocated array (*out, caller frees). Returns the count. */
+int workspace_load(ws_repo **out);
+
+/* The directory the repos live in, as workspace_load() resolves them: WORKSPACE_DIR, else the
+ * parent when the current directory is one of the repos, else the current directory. */
+void workspace_root(char *root, size_t size);
+
+/* Menu actions */
+void workspace_fetch_all(void);
+void workspace_commit_all(void);
+void workspace_status_all(void);
+
+/* Fetches the checked-out branch of every clone concurrently and fast-forwards those that are
+ * clean and strictly behind their upstream. Dirty, diverged, detached or untracked repos are
+ * reported, not touched. Prints a summary table; returns the number that failed. */
+int workspace_sync(void);
+
+#endif /* WORKSPACE_H */
@@ -0,0 +1,24 @@
+/* include/worktree.h
+ *
+ * Worktree-per-branch mode for the push flow (PUSH_WORKTREES=1).
+ * Instead of 'git checkout -b' in the main working tree, each feature branch gets its own
+ * 'git worktree' under WORKTREE_DIR (default '<repo>/../<repo>.worktrees/<branch>'), and later
+ * pushes to the same branch reuse it. The main tree keeps whatever it has checked out; its
+ * uncommitted changes are carried over to the branch's worktree (stash push / stash pop).
+ */
+
+#ifndef WORKTREE_H
+#define WORKTREE_H
+
+#include <stddef.h>
+
+/* 1 if PUSH_WORKTREES is set to 1. */
+int worktree_mode(void);
+
+/* Prepares the worktree of 'branch' (created from HEAD if the branch is new) and moves the
+ * current uncommitted changes into it. Writes its absolute path into 'dir'.
+ * Returns 0 on success, 1 if 'branch' is already checked out here (nothing to do, 'dir' = "."),
+ * -1 on failure (a failed move leaves the changes in 'git stash list'). */
+int worktree_enter(const char *branch, char *dir, size_t size);
+
+#endif /* WORKTREE_H */
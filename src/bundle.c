@@ -0,0 +1,139 @@
+/*
+ * Bundle Module
+ * -------------
+ * Author: Jaehoon, 2025
+ *
+ * Export, per repo (in the pool, one job each):
+ *   git bundle create <abs dir>/<name>.bundle --remotes=origin --tags
+ * Only origin's state goes in: local branches (unpushed work, '_cache_' snapshots) and
+ * whatever HEAD the exporter has checked out stay on this machine.
+ * git writes the bundle through a lock file, so an importer never sees a half-written one.
+ * The import side lives in the clone rounds (clone.c), which turn a bundle into
+ *   git init <dir> && git -C <dir> fetch <bundle> +refs/remotes/origin/<b>:refs/remotes/origin/<b>
+ *     && git -C <dir> remote add origin <url> && git -C <dir> fetch --prune origin
+ *     && git -C <dir> remote set-head origin --auto
+ * and then check out the profile's branch, else origin's default one.
+ */
+
+#include "core.h"
+#include "bundle.h"
+#include "workspace.h"
+#include "pool.h"
+#include "progress.h"
+#include "stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+void bundle_dir(char *dir, size_t size) {
+    const char *env = getenv("BUNDLE_DIR");
+    if (env && env[0]) {
+        snprintf(dir, size, "%s", env);
+        return;
+    }
+    /* Never inside a working tree, where 'git add .' would pick the bundles up */
+    char root[1024];
+    workspace_root(root, sizeof(root));
+    snprintf(dir, size, "%.*s/%s", (int)(size - sizeof(BUNDLE_DIR_DEFAULT) - 1), root, BUNDLE_DIR_DEFAULT);
+}
+
+int bundle_path(const char *name, char *path, size_t size) {
+    char dir[1024];
+    bundle_dir(dir, sizeof(dir));
+    int n = snprintf(path, size, "%s/%s.bundle", dir, name);
+    if (n < 0 || (size_t)n >= size) {
+        path[0] = '\0';
+        return 0;
+    }
+    for (char *p = path + strlen(dir) + 1; *p; p++) {
+        if (*p == '/' || *p == '\\') *p = '_'; /* nested repo paths stay one file */
+    }
+    return ACCESS(path) == 0;
+}
+
+long bundle_size(const char *name) {
+    char path[512];
+    bundle_path(name, path, sizeof(path));
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+void bundle_export_action(void) {
+    stats_set_flow("bundle-export");
+    clear_screen();
+    printf("--- EXPORT BUNDLES ---\n");
+
+    ws_repo *repos = NULL;
+    int repo_count = workspace_load(&repos);
+    char base[1024], cwd[1024] = "";
+    bundle_dir(base, sizeof(base));
+    if (repo_count == 0) {
+        printf("No repositories defined.\n");
+    } else if (MAKE_DIR(base) != 0 && errno != EEXIST) {
+        printf("Error: could not create %s.\n", base);
+        repo_count = 0;
+    } else if (!GET_CWD(cwd, sizeof(cwd))) {
+        printf("Error: could not resolve the current directory.\n");
+        repo_count = 0;
+    }
+    /* Jobs run inside each repo, so a relative bundle path is prefixed with ours */
+    int absolute = base[0] == '/' || base[0] == '\\' || (base[0] && base[1] == ':');
+
+    pool_job *jobs = calloc(repo_count > 0 ? repo_count : 1, sizeof(pool_job));
+    int job_count = 0;
+    for (int i = 0; jobs && i < repo_count; i++) {
+        if (!repos[i].exists) continue;
+        pool_job *job = &jobs[job_count++];
+        char file[512];
+        bundle_path(repos[i].name, file, sizeof(file));
+        snprintf(job->label, sizeof(job->label), "%s", repos[i].name);
+        snprintf(job->cwd, sizeof(job->cwd), "%s", repos[i].path);
+        snprintf(job->command, sizeof(job->command), "git bundle create --progress \"%s%s%s\" --remotes=origin --tags",
+                 absolute ? "" : cwd, absolute ? "" : "/", file);
+        progress_log_path(repos[i].name, "bundle", job->log_path, sizeof(job->log_path));
+    }
+
+    if (job_count > 0) {
+        int workers = pool_default_workers();
+        printf("Bundling %d repositories into %s/ with %d workers...\n", job_count, base, workers);
+        progress_view view;
+        if (progress_init(&view, "Bundling", job_count) == 0) {
+            pool_run_observed(jobs, job_count, workers, progress_observe, &view);
+            progress_finish(&view, jobs, job_count);
+            progress_free(&view);
+        } else {
+            pool_run(jobs, job_count, workers);
+        }
+
+        printf("\n=== BUNDLE SUMMARY ===\n\n");
+        printf("%-28s %-6s %9s  %s\n", "Repo", "Result", "Time(ms)", "Detail");
+        for (int j = 0; j < job_count; j++) {
+            char file[512];
+            bundle_path(jobs[j].label, file, sizeof(file));
+            if (jobs[j].exit_code == 0) {
+                printf("%-28s %-6s %9.0f  %s (%.1f MiB)\n", jobs[j].label, "ok", jobs[j].wall_ms, file,
+                       bundle_size(jobs[j].label) / (1024.0 * 1024.0));
+            } else {
+                printf("%-28s %-6s %9.0f  see %s\n", jobs[j].label, "FAIL", jobs[j].wall_ms, jobs[j].log_path);
+            }
+        }
+        for (int i = 0; i < repo_count; i++) {
+            if (!repos[i].exists) printf("%-28s %-6s %9s  %s\n", repos[i].name, "skip", "-", "not cloned");
+        }
+        printf("\nCopy %s/ into the workspace root of a new machine; the bootstrap clones from it\n"
+               "and fetches only the newer objects from origin.\n", base);
+    } else if (repo_count > 0) {
+        printf("No cloned repository to bundle.\n");
+    }
+
+    if (jobs) pool_free(jobs, job_count);
+    free(jobs);
+    free(repos);
+    lazyprintf("Next: Returning to main menu");
+    pausef(NULL);
+}
@@ -0,0 +1,545 @@
+/*
+ * Clone Profile Module
+ * --------------------
+ * Author: Jaehoon, 2025
+ *
+ * Turns a per-repo option string into 'git clone' flags and post-clone setup:
+ *   git clone [--filter=..] [--depth N] [--single-branch] [--branch B] [--sparse] url dir
+ *   git -C dir sparse-checkout set --cone <paths>      (sparse profiles only)
+ *   git -C dir config ...                              (fast paths)
+ *
+ * The journal (CLONE_JOURNAL in the workspace) holds one line per repo:
+ *   <state>\t<attempts>\t<name>\t<url>\t<size KiB>\t<clone ms>
+ * and is rewritten through a temporary file + rename after every state change, so a crash
+ * leaves either the old or the new version, never a torn one.
+ */
+
+#include "core.h"
+#include "clone.h"
+#include "tune.h"
+#include "pool.h"
+#include "progress.h"
+#include "bundle.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* --- PARSING --- */
+int clone_parse_profile(const char *spec, clone_profile *profile, char *error, size_t error_size) {
+    memset(profile, 0, sizeof(*profile));
+    if (error_size > 0) error[0] = '\0';
+    if (!spec) return 0;
+
+    char copy[1024];
+    snprintf(copy, sizeof(copy), "%s", spec);
+    for (char *token = strtok(copy, " \t"); token; token = strtok(NULL, " \t")) {
+        if (strcmp(token, "default") == 0 || strcmp(token, "full") == 0) {
+            continue;
+        } else if (strcmp(token, "partial") == 0) {
+            snprintf(profile->filter, sizeof(profile->filter), "blob:none");
+        } else if (strncmp(token, "filter=", 7) == 0 && token[7]) {
+            snprintf(profile->filter, sizeof(profile->filter), "%s", token + 7);
+        } else if (strcmp(token, "shallow") == 0) {
+            profile->depth = 1;
+        } else if (strncmp(token, "depth=", 6) == 0 && atoi(token + 6) > 0) {
+            profile->depth = atoi(token + 6);
+        } else if (strcmp(token, "single-branch") == 0) {
+            profile->single_branch = 1;
+        } else if (strncmp(token, "branch=", 7) == 0 && token[7]) {
+            snprintf(profile->branch, sizeof(profile->branch), "%s", token + 7);
+        } else if (strncmp(token, "sparse=", 7) == 0 && token[7]) {
+            snprintf(profile->sparse, sizeof(profile->sparse), "%s", token + 7);
+        } else {
+            snprintf(error, error_size, "unknown clone option '%s'", token);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void clone_describe(const clone_profile *profile, char *buf, size_t size) {
+    char text[768] = "";
+    if (profile->filter[0]) {
+        if (strcmp(profile->filter, "blob:none") == 0) strcat(text, ", partial");
+        else snprintf(text + strlen(text), sizeof(text) - strlen(text), ", filter %s", profile->filter);
+    }
+    if (profile->depth > 0) snprintf(text + strlen(text), sizeof(text) - strlen(text), ", depth %d", profile->depth);
+    if (profile->single_branch) strcat(text, ", single-branch");
+    if (profile->branch[0]) snprintf(text + strlen(text), sizeof(text) - strlen(text), ", branch %s", profile->branch);
+    if (profile->sparse[0]) snprintf(text + strlen(text), sizeof(text) - strlen(text), ", sparse: %s", profile->sparse);
+    snprintf(buf, size, "%s", text[0] ? text + 2 : "full");
+}
+
+/* --- CLONING --- */
+/* 'git clone' command line for the profile. With a 'bundle' (NULL = none) the repository is
+ * seeded from that local file instead: only origin's branches and the tags are taken from it,
+ * then origin is added and only the difference is fetched. The checkout of a seeded clone is
+ * done afterwards by seed_checkout(). */
+static void clone_command(const char *url, const char *dir, const clone_profile *profile,
+                          const char *bundle, char *command, size_t size) {
+    char flags[1024] = "";
+    if (profile->filter[0]) snprintf(flags + strlen(flags), sizeof(flags) - strlen(flags), " --filter=%s", profile->filter);
+    if (profile->depth > 0) snprintf(flags + strlen(flags), sizeof(flags) - strlen(flags), " --depth %d", profile->depth);
+    if (profile->single_branch) strcat(flags, " --single-branch");
+    if (profile->branch[0]) snprintf(flags + strlen(flags), sizeof(flags) - strlen(flags), " --branch \"%s\"", profile->branch);
+    if (profile->sparse[0]) strcat(flags, " --sparse"); /* only top-level files until the cone is set */
+
+    /* --progress: git drops progress output when stderr is a pipe */
+    if (!bundle) {
+        snprintf(command, size, "git clone --progress%s \"%s\" \"%s\"", flags, url, dir);
+        return;
+    }
+    char heads[300], track[300] = "";
+    if (profile->single_branch) {
+        snprintf(heads, sizeof(heads), "refs/remotes/origin/%s", profile->branch);
+        snprintf(track, sizeof(track), " -t \"%s\"", profile->branch);
+    } else {
+        snprintf(heads, sizeof(heads), "refs/remotes/origin/*");
+    }
+    /* The bundle is fetched with --git-dir, not -C, so a relative bundle path still resolves */
+    snprintf(command, size,
+             "git init -q \"%s\" && git --git-dir=\"%s/.git\" fetch --progress \"%s\" \"+%s:%s\" \"+refs/tags/*:refs/tags/*\" && "
+             "git -C \"%s\" remote add%s origin \"%s\" && git -C \"%s\" fetch --progress --prune origin",
+             dir, dir, bundle, heads, heads, dir, track, url, dir);
+    /* A single-branch clone tracks only its branch, so origin's HEAD may point at nothing here */
+    if (!profile->single_branch) {
+        snprintf(command + strlen(command), size - strlen(command), " && git -C \"%s\" remote set-head origin --auto", dir);
+    }
+}
+
+/* Checks out the profile's branch, else origin's default one, in a seeded clone */
+static int seed_checkout(const char *dir, const clone_profile *profile) {
+    char branch[256];
+    if (profile->branch[0]) {
+        snprintf(branch, sizeof(branch), "%s", profile->branch);
+    } else {
+        char head[256];
+        if (!read_cmd_line(head, sizeof(head), "git -C \"%s\" symbolic-ref -q --short refs/remotes/origin/HEAD", dir) ||
+            strncmp(head, "origin/", 7) != 0) return -1;
+        snprintf(branch, sizeof(branch), "%s", head + 7);
+    }
+    return run_cmd("git -C \"%s\" checkout -q -B \"%s\" --track \"origin/%s\"", dir, branch, branch);
+}
+
+int clone_set_sparse(const char *dir, const clone_profile *profile) {
+    char paths[1024] = "", copy[512];
+    snprintf(copy, sizeof(copy), "%s", profile->sparse);
+    for (char *path = strtok(copy, ","); path; path = strtok(NULL, ",")) {
+        snprintf(paths + strlen(paths), sizeof(paths) - strlen(paths), " \"%s\"", path);
+    }
+    if (run_cmd("git -C \"%s\" sparse-checkout set --cone%s", dir, paths) != 0) {
+        printf("Warning: could not set sparse paths for %s.\n", dir);
+        return -1;
+    }
+    return 0;
+}
+
+/* Post-clone setup: sparse paths and fast paths */
+static void clone_setup(const char *dir, const clone_profile *profile) {
+    if (profile->sparse[0]) clone_set_sparse(dir, profile);
+    clone_enable_fast_paths(dir, profile);
+}
+
+void clone_enable_fast_paths(const char *dir, const clone_profile *profile) {
+    /* Commit-graph: faster log/merge-base/reachability; kept current by every fetch.
+     * Shallow clones cannot use it, so only write one for full history. */
+    run_cmd("git -C \"%s\" config core.commitGraph true", dir);
+    run_cmd("git -C \"%s\" config fetch.writeCommitGraph true", dir);
+    if (!profile || profile->depth == 0) run_cmd("git -C \"%s\" commit-graph write --reachable --changed-paths", dir);
+
+    /* Untracked cache: status/add skip directories whose mtime did not change */
+    run_cmd("git -C \"%s\" config core.untrackedCache true", dir);
+
+#if defined(_WIN32) || defined(__APPLE__)
+    /* Builtin fsmonitor daemon: status/add only look at files the OS reported as changed */
+    run_cmd("git -C \"%s\" config core.fsmonitor true", dir);
+#endif
+}
+
+/* --- JOURNAL --- */
+static const char *STATE_NAMES[] = { "pending", "in-progress", "verified", "failed" };
+
+int clone_journal_load(clone_journal *journal) {
+    memset(journal, 0, sizeof(*journal));
+    snprintf(journal->path, sizeof(journal->path), "%s", CLONE_JOURNAL);
+    FILE *f = fopen(journal->path, "r");
+    if (!f) return 0;
+
+    char line[1400];
+    int capacity = 0;
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char *fields[6];
+        int n = 0;
+        for (char *p = line; n < 6 && p; n++) {
+            fields[n] = p;
+            p = (n < 5) ? strchr(p, '\t') : NULL;
+            if (p) *p++ = '\0';
+        }
+        if (n < 4) continue; /* size and time were added later: optional */
+
+        if (journal->count >= capacity) {
+            capacity = capacity ? capacity * 2 : 32;
+            journal_entry *tmp = realloc(journal->entries, sizeof(journal_entry) * capacity);
+            if (!tmp) {
+                fclose(f);
+                return -1;
+            }
+            journal->entries = tmp;
+        }
+        journal_entry *entry = &journal->entries[journal->count];
+        entry->state = CLONE_PENDING;
+        for (int s = 0; s < 4; s++) {
+            if (strcmp(fields[0], STATE_NAMES[s]) == 0) entry->state = (clone_state)s;
+        }
+        entry->attempts = atoi(fields[1]);
+        snprintf(entry->name, sizeof(entry->name), "%s", fields[2]);
+        snprintf(entry->url, sizeof(entry->url), "%s", fields[3]);
+        entry->size_kb = n > 4 ? atol(fields[4]) : 0;
+        entry->clone_ms = n > 5 ? atof(fields[5]) : 0;
+        journal->count++;
+    }
+    fclose(f);
+    return 0;
+}
+
+static int journal_save(const clone_journal *journal) {
+    char tmp_path[1100];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", journal->path);
+    FILE *f = fopen(tmp_path, "w");
+    if (!f) return -1;
+    for (int i = 0; i < journal->count; i++) {
+        const journal_entry *entry = &journal->entries[i];
+        fprintf(f, "%s\t%d\t%s\t%s\t%ld\t%.0f\n", STATE_NAMES[entry->state], entry->attempts,
+                entry->name, entry->url, entry->size_kb, entry->clone_ms);
+    }
+    if (fclose(f) != 0) {
+        remove(tmp_path);
+        return -1;
+    }
+#ifdef _WIN32
+    remove(journal->path); /* rename() does not replace on Windows */
+#endif
+    return rename(tmp_path, journal->path) == 0 ? 0 : -1;
+}
+
+void clone_journal_free(clone_journal *journal) {
+    free(journal->entries);
+    journal->entries = NULL;
+    journal->count = 0;
+}
+
+const journal_entry *clone_journal_find(const clone_journal *journal, const char *name) {
+    for (int i = 0; i < journal->count; i++) {
+        if (strcmp(journal->entries[i].name, name) == 0) return &journal->entries[i];
+    }
+    return NULL;
+}
+
+/* Entry for 'name', added as pending (or reset if the URL changed). NULL if out of memory. */
+static journal_entry *journal_entry_for(clone_journal *journal, const char *name, const char *url) {
+    journal_entry *entry = (journal_entry *)clone_journal_find(journal, name);
+    if (!entry) {
+        journal_entry *tmp = realloc(journal->entries, sizeof(journal_entry) * (journal->count + 1));
+        if (!tmp) return NULL;
+        journal->entries = tmp;
+        entry = &journal->entries[journal->count++];
+        memset(entry, 0, sizeof(*entry));
+        snprintf(entry->name, sizeof(entry->name), "%s", name);
+    } else if (strcmp(entry->url, url) == 0) {
+        return entry;
+    }
+    snprintf(entry->url, sizeof(entry->url), "%s", url);
+    entry->state = CLONE_PENDING;
+    entry->attempts = 0;
+    entry->size_kb = 0; /* another repository now */
+    entry->clone_ms = 0;
+    return entry;
+}
+
+int clone_is_complete(const clone_journal *journal, const char *dir) {
+    if (ACCESS(dir) != 0) return 0;
+    const journal_entry *entry = clone_journal_find(journal, dir);
+    return !entry || entry->state == CLONE_VERIFIED || entry->state == CLONE_PENDING;
+}
+
+/* --- RESUMABLE BOOTSTRAP --- */
+static int verify_clone(const char *dir) {
+    return run_cmd("git -C \"%s\" rev-parse -q --verify \"HEAD^{commit}\" >%s 2>&1", dir, NULL_DEVICE) == 0;
+}
+
+static void remove_tree(const char *dir) {
+    if (ACCESS(dir) != 0) return;
+#ifdef _WIN32
+    run_cmd("rmdir /s /q \"%s\"", dir);
+#else
+    run_cmd("rm -rf \"%s\"", dir);
+#endif
+}
+
+/* Failures worth another attempt: network and server hiccups, not bad URLs or credentials.
+ * Only the end of the output is looked at; that is where git reports the error. */
+static int is_transient(const char *output, size_t len) {
+    static const char *patterns[] = {
+        "could not resolve host", "timed out", "connection reset", "connection refused",
+        "early eof", "rpc failed", "remote end hung up", "unexpected disconnect",
+        "returned error: 5", "temporary failure", "gnutls", "ssl_read", "ssl_connect", "broken pipe"
+    };
+    if (!output) return 0;
+    char lower[2048];
+    const char *tail = output + (len > sizeof(lower) - 1 ? len - (sizeof(lower) - 1) : 0);
+    size_t i;
+    for (i = 0; tail[i] && i < sizeof(lower) - 1; i++) lower[i] = (char)tolower((unsigned char)tail[i]);
+    lower[i] = '\0';
+    for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++) {
+        if (strstr(lower, patterns[p])) return 1;
+    }
+    return 0;
+}
+
+/* --- SCHEDULING --- */
+/* Object store size of a clone in KiB ('git count-objects -v': size + size-pack), 0 if unknown */
+static long repo_size_kb(const char *dir) {
+    FILE *fp = open_cmd("r", "git -C \"%s\" count-objects -v", dir);
+    if (!fp) return 0;
+    char line[256];
+    long total = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, "size: ", 6) == 0) total += atol(line + 6);
+        else if (strncmp(line, "size-pack: ", 11) == 0) total += atol(line + 11);
+    }
+    close_cmd(fp);
+    return total;
+}
+
+/* KiB per ms over the journaled clones with both a size and a duration, 0 if there are none */
+static double journal_rate(const clone_journal *journal) {
+    double kb = 0, ms = 0;
+    for (int i = 0; i < journal->count; i++) {
+        if (journal->entries[i].size_kb <= 0 || journal->entries[i].clone_ms <= 0) continue;
+        kb += journal->entries[i].size_kb;
+        ms += journal->entries[i].clone_ms;
+    }
+    return ms > 0 ? kb / ms : 0;
+}
+
+/* Expected download in KiB: the last clone's size from the journal, else the bundle's, else
+ * the last clone's duration at the journal's average rate, else -1 */
+static long size_estimate(const clone_journal *journal, const char *name, double rate) {
+    const journal_entry *entry = clone_journal_find(journal, name);
+    if (entry && entry->size_kb > 0) return entry->size_kb;
+    long bytes = bundle_size(name);
+    if (bytes >= 0) return bytes / 1024;
+    if (entry && entry->clone_ms > 0 && rate > 0) return (long)(entry->clone_ms * rate);
+    return -1;
+}
+
+/* Orders todo[] by priority (highest first), then expected size (smallest first, unknown sizes
+ * counted as the average of the known ones), then manifest order. With more repos than
+ * workers, the largest repo of the first priority tier is moved to the front instead: it
+ * streams in on one worker while the others work through the small ones. */
+static void schedule_clones(const clone_journal *journal, const char **names, const int *priorities,
+                            int *todo, int n, int workers) {
+    long *size = malloc(sizeof(long) * (n > 0 ? n : 1));
+    if (!size) return;
+    double rate = journal_rate(journal);
+    long known_total = 0;
+    int known = 0;
+    for (int k = 0; k < n; k++) {
+        size[k] = size_estimate(journal, names[todo[k]], rate);
+        if (size[k] >= 0) {
+            known_total += size[k];
+            known++;
+        }
+    }
+    for (int k = 0; k < n; k++) {
+        if (size[k] < 0) size[k] = known ? known_total / known : 0;
+    }
+
+    /* Stable insertion sort: n is the number of repos */
+    for (int k = 1; k < n; k++) {
+        int item = todo[k];
+        long item_size = size[k];
+        int prio = priorities ? priorities[item] : 0;
+        int j = k - 1;
+        while (j >= 0) {
+            int other = priorities ? priorities[todo[j]] : 0;
+            if (other > prio || (other == prio && (size[j] < item_size || (size[j] == item_size && todo[j] < item)))) break;
+            todo[j + 1] = todo[j];
+            size[j + 1] = size[j];
+            j--;
+        }
+        todo[j + 1] = item;
+        size[j + 1] = item_size;
+    }
+
+    int largest = 0;
+    for (int k = 1; k < n; k++) {
+        int same_tier = !priorities || priorities[todo[k]] == priorities[todo[0]];
+        if (same_tier && size[k] > size[largest]) largest = k;
+    }
+    if (workers >= 2 && n > workers && largest > 0 && size[largest] > 0) {
+        int item = todo[largest];
+        memmove(&todo[1], &todo[0], sizeof(int) * largest);
+        todo[0] = item;
+    }
+
+    printf("Clone order:");
+    for (int k = 0; k < n; k++) {
+        long kb = size_estimate(journal, names[todo[k]], rate);
+        if (kb >= 0) printf("%s %s (%.1f MiB)", k ? "," : "", names[todo[k]], kb / 1024.0);
+        else printf("%s %s (size unknown)", k ? "," : "", names[todo[k]]);
+    }
+    printf("\n\n");
+    free(size);
+}
+
+/* Clones the repos todo[0..*todo_count) concurrently under a progress view, seeding each from
+ * its bundle (bundle.h) unless no_bundle[i] is set or the profile is partial/shallow. Finished
+ * clones are verified and set up; transient failures and failed bundle seeds are left in 'todo'
+ * (count updated) for the next round unless 'last_round'; *transient counts the former.
+ * Returns the number that failed for good. */
+static int clone_round(clone_journal *journal, const char **urls, const char **names, const clone_profile *profiles,
+                       char *no_bundle, int *todo, int *todo_count, int last_round, int *transient) {
+    int n = *todo_count, failed = 0;
+    pool_job *jobs = calloc((size_t)n, sizeof(pool_job));
+    if (!jobs) {
+        printf("Error: out of memory.\n");
+        *todo_count = 0;
+        return n;
+    }
+    for (int k = 0; k < n; k++) {
+        int i = todo[k];
+        journal_entry *entry = (journal_entry *)clone_journal_find(journal, names[i]);
+        entry->state = CLONE_IN_PROGRESS;
+        entry->attempts++;
+        char bundle[512];
+        /* A single-branch seed needs the branch name before origin's default is known */
+        int seedable = !profiles[i].filter[0] && profiles[i].depth == 0 &&
+                       (!profiles[i].single_branch || profiles[i].branch[0]);
+        int seeded = !no_bundle[i] && seedable && bundle_path(names[i], bundle, sizeof(bundle));
+        if (!seeded) no_bundle[i] = 1;
+        snprintf(jobs[k].label, sizeof(jobs[k].label), "%s%s", names[i], seeded ? " (bundle)" : "");
+        clone_command(urls[i], names[i], &profiles[i], seeded ? bundle : NULL, jobs[k].command, sizeof(jobs[k].command));
+        progress_log_path(names[i], "clone", jobs[k].log_path, sizeof(jobs[k].log_path));
+    }
+    journal_save(journal);
+
+    progress_view view;
+    if (progress_init(&view, "Cloning", n) == 0) {
+        pool_run_observed(jobs, n, pool_default_workers(), progress_observe, &view);
+        progress_finish(&view, jobs, n);
+        progress_free(&view);
+    } else {
+        pool_run(jobs, n, pool_default_workers());
+    }
+
+    int retry = 0;
+    *transient = 0;
+    for (int k = 0; k < n; k++) {
+        int i = todo[k];
+        journal_entry *entry = (journal_entry *)clone_journal_find(journal, names[i]);
+        int ok = jobs[k].exit_code == 0 && (no_bundle[i] || seed_checkout(names[i], &profiles[i]) == 0);
+        if (ok && verify_clone(names[i])) {
+            clone_setup(names[i], &profiles[i]);
+            entry->state = CLONE_VERIFIED;
+            entry->size_kb = repo_size_kb(names[i]);
+            entry->clone_ms = jobs[k].wall_ms;
+            journal_save(journal);
+            tune_repo(names[i], 0);
+            continue;
+        }
+        remove_tree(names[i]);
+        if (!last_round && !no_bundle[i]) {
+            printf("%s: seeding from the bundle failed, cloning from origin next.\n", names[i]);
+            no_bundle[i] = 1;
+            todo[retry++] = i;
+            continue;
+        }
+        if (!last_round && is_transient(jobs[k].output, jobs[k].output_len)) {
+            todo[retry++] = i; /* stays in-progress until the next round */
+            (*transient)++;
+            continue;
+        }
+        entry->state = CLONE_FAILED;
+        printf("Error: could not clone %s (log: %s).\n", names[i], jobs[k].log_path[0] ? jobs[k].log_path : "none");
+        failed++;
+    }
+    journal_save(journal);
+    pool_free(jobs, n);
+    free(jobs);
+    *todo_count = retry;
+    return failed;
+}
+
+int clone_all(const char **urls, const char **names, const clone_profile *profiles,
+              const int *priorities, int count) {
+    clone_journal journal;
+    if (clone_journal_load(&journal) != 0) {
+        printf("Error: could not read %s.\n", CLONE_JOURNAL);
+        return count;
+    }
+    const char *env = getenv("CLONE_RETRIES");
+    int max_attempts = (env && atoi(env) > 0) ? atoi(env) : 3;
+
+    int *todo = malloc(sizeof(int) * (count > 0 ? count : 1));
+    char *no_bundle = calloc(count > 0 ? count : 1, 1);
+    if (!todo || !no_bundle) {
+        free(todo);
+        free(no_bundle);
+        clone_journal_free(&journal);
+        return count;
+    }
+
+    /* 1. Decide what each directory on disk is worth */
+    int failed = 0, todo_count = 0;
+    for (int i = 0; i < count; i++) {
+        journal_entry *entry = journal_entry_for(&journal, names[i], urls[i]);
+        if (!entry) {
+            failed++;
+            continue;
+        }
+        if (ACCESS(names[i]) == 0) {
+            /* A failed clone was already cleaned up, so a FAILED directory was made by hand */
+            if (entry->state == CLONE_IN_PROGRESS) {
+                printf("[%d/%d] %s: removing interrupted clone...\n", i + 1, count, names[i]);
+                remove_tree(names[i]);
+            } else if (verify_clone(names[i])) {
+                if (entry->state != CLONE_VERIFIED) {
+                    entry->state = CLONE_VERIFIED; /* cloned before the journal, or by hand */
+                    journal_save(&journal);
+                }
+                printf("[%d/%d] %s already cloned, skipping...\n", i + 1, count, names[i]);
+                continue;
+            } else {
+                /* Not ours to delete */
+                printf("[%d/%d] %s exists but is not a valid clone, skipping. Remove it to retry.\n",
+                       i + 1, count, names[i]);
+                failed++;
+                continue;
+            }
+        }
+        todo[todo_count++] = i;
+    }
+
+    /* 2. Clone concurrently, small and important repos first; transient failures go again
+     * after an exponential backoff */
+    schedule_clones(&journal, names, priorities, todo, todo_count, pool_default_workers());
+    int transient = 0;
+    for (int attempt = 1; attempt <= max_attempts && todo_count > 0; attempt++) {
+        if (transient > 0) {
+            int delay_ms = 2000 << (attempt - 2);
+            printf("%d transient failure(s), retrying in %d s...\n", transient, delay_ms / 1000);
+            SLEEP_MS(delay_ms);
+        }
+        failed += clone_round(&journal, urls, names, profiles, no_bundle, todo, &todo_count,
+                              attempt == max_attempts, &transient);
+    }
+    printf("\n");
+
+    free(todo);
+    free(no_bundle);
+    clone_journal_free(&journal);
+    return failed;
+}
@@ -5,10 +5,22 @@
  */
 
 #include "core.h"
+#include "stats.h"
+#include "replay.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#endif
 
 /* --- TERMINAL CONTROL (POSIX only) --- */
 #ifndef _WIN32
@@ -45,6 +57,32 @@ void clear_screen(void) {
 #endif
 }
 
+int terminal_rows(void) {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        return info.srWindow.Bottom - info.srWindow.Top + 1;
+    }
+#else
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0) return ws.ws_row;
+#endif
+    return 24;
+}
+
+int terminal_cols(void) {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        return info.srWindow.Right - info.srWindow.Left + 1;
+    }
+#else
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0) return ws.ws_col;
+#endif
+    return 80;
+}
+
 /* --- USER INPUT --- */
 void pausef(const char *fmt, ...) {
     /* Print optional custom message if provided */
@@ -64,14 +102,17 @@ void pausef(const char *fmt, ...) {
     disable_raw_mode();
     
     /* POSIX: Read a single character from stdin */
-    int c = getchar();
-    (void)c; /* Suppress unused variable warning */
+    input_wait(INPUT_PAUSE);
+    char c = (char)getchar();
+    input_record(INPUT_PAUSE, &c, 1);
     
     /* Only re-enable raw mode if it was enabled before */
     enable_raw_mode();
 #else
     /* Windows: Use _getch() to wait for any key */
-    _getch();
+    input_wait(INPUT_PAUSE);
+    char c = (char)_getch();
+    input_record(INPUT_PAUSE, &c, 1);
 #endif
     printf("\n");
 }
@@ -83,8 +124,10 @@ void get_input_string(char *buffer, int size) {
 #endif
 
     printf(" > ");
+    input_wait(INPUT_LINE);
     if (fgets(buffer, size, stdin) != NULL) {
         size_t len = strlen(buffer);
+        input_record(INPUT_LINE, buffer, len);
         if (len > 0 && buffer[len-1] == '\n') {
             buffer[len-1] = '\0';
         }
@@ -96,12 +139,18 @@ void get_input_string(char *buffer, int size) {
 }
 
 int get_key(void) {
+    input_wait(INPUT_KEY);
 #ifdef _WIN32
     int ch = _getch();
     if (ch == 0 || ch == 224) {
+        char raw[2] = { (char)ch, 0 };
         ch = _getch(); // Arrow keys are 2-byte sequences on Windows
+        raw[1] = (char)ch;
+        input_record(INPUT_KEY, raw, 2);
         return ch;
     }
+    char raw = (char)ch;
+    input_record(INPUT_KEY, &raw, 1);
     return ch;
 #else
     int nread;
@@ -109,26 +158,312 @@ int get_key(void) {
     while ((nread = read(STDIN_FILENO, &c, 1)) != 1);
     if (c == '\x1b') {
         char seq[3];
-        if (read(STDIN_FILENO, &seq[0], 1) != 1) return '\x1b';
-        if (read(STDIN_FILENO, &seq[1], 1) != 1) return '\x1b';
+        if (read(STDIN_FILENO, &seq[0], 1) != 1) { input_record(INPUT_KEY, &c, 1); return '\x1b'; }
+        if (read(STDIN_FILENO, &seq[1], 1) != 1) { input_record(INPUT_KEY, &c, 1); return '\x1b'; }
+        char raw[3] = { c, seq[0], seq[1] };
+        input_record(INPUT_KEY, raw, 3);
         if (seq[0] == '[') {
             if (seq[1] == 'A') return KEY_UP;
             if (seq[1] == 'B') return KEY_DOWN;
         }
         return 0;
     }
+    input_record(INPUT_KEY, &c, 1);
     return c;
 #endif
 }
 
+/* --- TIMING --- */
+double now_ms(void) {
+#ifdef _WIN32
+    return (double)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+/* --- SYSTEM INFO --- */
+int cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count > 0 ? count : 1;
+}
+
+int absolute_path(const char *path, char *out, size_t size) {
+#ifdef _WIN32
+    return _fullpath(out, path, size) ? 0 : -1;
+#else
+    char *resolved = realpath(path, NULL);
+    if (!resolved) return -1;
+    int n = snprintf(out, size, "%s", resolved);
+    free(resolved);
+    return n >= 0 && (size_t)n < size ? 0 : -1;
+#endif
+}
+
 /* --- SYSTEM COMMANDS --- */
+#ifndef _WIN32
+pid_t spawn_shell(const char *cwd, const char *command, int child_in, int child_out, int child_err) {
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (child_in >= 0 && child_in != STDIN_FILENO) dup2(child_in, STDIN_FILENO);
+        if (child_out >= 0 && child_out != STDOUT_FILENO) dup2(child_out, STDOUT_FILENO);
+        if (child_err >= 0 && child_err != STDERR_FILENO) dup2(child_err, STDERR_FILENO);
+        if (cwd && cwd[0] && chdir(cwd) != 0) _exit(127);
+        execl("/bin/sh", "sh", "-c", command, (char *)NULL);
+        _exit(127);
+    }
+    return pid;
+}
+
+static void record_usage(const struct rusage *ru, const char *command, double start_ms) {
+    proc_usage usage;
+    usage.wall_ms = now_ms() - start_ms;
+    usage.user_ms = ru->ru_utime.tv_sec * 1000.0 + ru->ru_utime.tv_usec / 1000.0;
+    usage.sys_ms = ru->ru_stime.tv_sec * 1000.0 + ru->ru_stime.tv_usec / 1000.0;
+#ifdef __APPLE__
+    usage.max_rss_kb = ru->ru_maxrss / 1024; /* bytes on macOS */
+#else
+    usage.max_rss_kb = ru->ru_maxrss;
+#endif
+    usage.in_blocks = ru->ru_inblock;
+    usage.out_blocks = ru->ru_oublock;
+    stats_record(command, &usage);
+}
+
+int reap_child(pid_t pid, const char *command, double start_ms) {
+    int status = -1;
+    struct rusage ru;
+    memset(&ru, 0, sizeof(ru));
+    while (wait4(pid, &status, 0, &ru) < 0) {
+        if (errno != EINTR) return -1;
+    }
+    record_usage(&ru, command, start_ms);
+    return status;
+}
+#endif
+
+/* --- BACKGROUND COMMANDS --- */
+int bg_start(bg_cmd *job, int nice_level, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(job->command, sizeof(job->command), fmt, args);
+    va_end(args);
+    job->running = 0;
+    job->exit_code = -1;
+    job->start_ms = now_ms();
+
+#ifdef _WIN32
+    (void)nice_level;
+    job->exit_code = run_cmd("%s >NUL 2>&1", job->command);
+    return 0;
+#else
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        int null_fd = open("/dev/null", O_RDWR);
+        if (null_fd >= 0) {
+            dup2(null_fd, STDIN_FILENO);
+            dup2(null_fd, STDOUT_FILENO);
+            dup2(null_fd, STDERR_FILENO);
+            if (null_fd > STDERR_FILENO) close(null_fd);
+        }
+        if (nice_level > 0) setpriority(PRIO_PROCESS, 0, nice_level);
+        setenv("GIT_TERMINAL_PROMPT", "0", 1); /* no credential prompts on the tty */
+        execl("/bin/sh", "sh", "-c", job->command, (char *)NULL);
+        _exit(127);
+    }
+    job->pid = pid;
+    job->running = 1;
+    return 0;
+#endif
+}
+
+int bg_done(bg_cmd *job) {
+    if (!job->running) return 1;
+#ifndef _WIN32
+    int status;
+    struct rusage ru;
+    memset(&ru, 0, sizeof(ru));
+    pid_t got = wait4(job->pid, &status, WNOHANG, &ru);
+    if (got == 0 || (got < 0 && errno == EINTR)) return 0;
+    job->running = 0;
+    if (got < 0) return 1;
+    record_usage(&ru, job->command, job->start_ms);
+    job->exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+    return 1;
+}
+
+int bg_join(bg_cmd *job) {
+    if (!job->running) return job->exit_code;
+#ifndef _WIN32
+    int status = reap_child(job->pid, job->command, job->start_ms);
+    job->running = 0;
+    job->exit_code = (status >= 0 && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+#endif
+    return job->exit_code;
+}
+
 int run_cmd(const char *fmt, ...) {
-    char command[1024];
+    char small[1024];
+    char *command = small;
+    va_list args;
+    va_start(args, fmt);
+    int needed = vsnprintf(small, sizeof(small), fmt, args);
+    va_end(args);
+
+    /* Long commands (e.g. many refspecs) get a heap buffer instead of being truncated */
+    if (needed >= (int)sizeof(small)) {
+        command = malloc((size_t)needed + 1);
+        if (!command) return -1;
+        va_start(args, fmt);
+        vsnprintf(command, (size_t)needed + 1, fmt, args);
+        va_end(args);
+    }
+
+#ifdef _WIN32
+    double start = now_ms();
+    int status = system(command);
+    proc_usage usage = { now_ms() - start, 0, 0, 0, 0, 0 };
+    stats_record(command, &usage);
+    if (command != small) free(command);
+    return status;
+#else
+    /* Same signal handling as system(): the parent ignores SIGINT/SIGQUIT while waiting */
+    struct sigaction ignore, old_int, old_quit;
+    memset(&ignore, 0, sizeof(ignore));
+    ignore.sa_handler = SIG_IGN;
+    sigemptyset(&ignore.sa_mask);
+    sigaction(SIGINT, &ignore, &old_int);
+    sigaction(SIGQUIT, &ignore, &old_quit);
+
+    double start = now_ms();
+    pid_t pid = spawn_shell(NULL, command, -1, -1, -1);
+    int status = -1;
+    if (pid > 0) status = reap_child(pid, command, start);
+
+    sigaction(SIGINT, &old_int, NULL);
+    sigaction(SIGQUIT, &old_quit, NULL);
+    if (command != small) free(command);
+    return status;
+#endif
+}
+
+/* Commands opened by open_cmd(), so close_cmd() can find their pid */
+#define MAX_OPEN_CMDS 16
+static struct {
+    FILE *fp;
+#ifndef _WIN32
+    pid_t pid;
+#endif
+    double start_ms;
+    char *command;          /* heap, sized to the command, so long ones are never cut */
+} open_cmds[MAX_OPEN_CMDS];
+
+static FILE *open_cmd_va(const char *mode, const char *fmt, va_list args) {
+    int slot = -1;
+    for (int i = 0; i < MAX_OPEN_CMDS; i++) {
+        if (open_cmds[i].fp == NULL) { slot = i; break; }
+    }
+    if (slot < 0) return NULL;
+
+    va_list copy;
+    va_copy(copy, args);
+    int needed = vsnprintf(NULL, 0, fmt, copy);
+    va_end(copy);
+    char *command = needed >= 0 ? malloc((size_t)needed + 1) : NULL;
+    if (!command) return NULL;
+    vsnprintf(command, (size_t)needed + 1, fmt, args);
+    open_cmds[slot].start_ms = now_ms();
+
+#ifdef _WIN32
+    open_cmds[slot].fp = _popen(command, mode);
+    if (open_cmds[slot].fp) open_cmds[slot].command = command;
+    else free(command);
+    return open_cmds[slot].fp;
+#else
+    int reading = (mode[0] == 'r');
+    int fds[2];
+    if (pipe(fds) != 0) {
+        free(command);
+        return NULL;
+    }
+    /* Our end must not leak into other children */
+    fcntl(reading ? fds[0] : fds[1], F_SETFD, FD_CLOEXEC);
+
+    pid_t pid = reading ? spawn_shell(NULL, command, -1, fds[1], -1)
+                        : spawn_shell(NULL, command, fds[0], -1, -1);
+    close(reading ? fds[1] : fds[0]);
+    if (pid < 0) {
+        close(reading ? fds[0] : fds[1]);
+        free(command);
+        return NULL;
+    }
+
+    FILE *fp = fdopen(reading ? fds[0] : fds[1], reading ? "r" : "w");
+    if (!fp) {
+        close(reading ? fds[0] : fds[1]);
+        reap_child(pid, command, open_cmds[slot].start_ms);
+        free(command);
+        return NULL;
+    }
+    open_cmds[slot].fp = fp;
+    open_cmds[slot].pid = pid;
+    open_cmds[slot].command = command;
+    return fp;
+#endif
+}
+
+FILE *open_cmd(const char *mode, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    FILE *fp = open_cmd_va(mode, fmt, args);
+    va_end(args);
+    return fp;
+}
+
+int close_cmd(FILE *fp) {
+    for (int i = 0; i < MAX_OPEN_CMDS; i++) {
+        if (fp == NULL || open_cmds[i].fp != fp) continue;
+        open_cmds[i].fp = NULL;
+#ifdef _WIN32
+        int status = _pclose(fp);
+        proc_usage usage = { now_ms() - open_cmds[i].start_ms, 0, 0, 0, 0, 0 };
+        stats_record(open_cmds[i].command, &usage);
+        free(open_cmds[i].command);
+        open_cmds[i].command = NULL;
+        return status;
+#else
+        fclose(fp);
+        int status = reap_child(open_cmds[i].pid, open_cmds[i].command, open_cmds[i].start_ms);
+        free(open_cmds[i].command);
+        open_cmds[i].command = NULL;
+        if (status == -1) return -1;
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+    }
+    return -1;
+}
+
+int read_cmd_line(char *buf, size_t size, const char *fmt, ...) {
     va_list args;
     va_start(args, fmt);
-    vsnprintf(command, sizeof(command), fmt, args);
+    FILE *fp = open_cmd_va("r", fmt, args);
     va_end(args);
-    return system(command);
+    if (!fp) return 0;
+    buf[0] = '\0';
+    if (fgets(buf, (int)size, fp)) buf[strcspn(buf, "\r\n")] = '\0';
+    return close_cmd(fp) == 0 && buf[0] != '\0';
 }
 
 /* --- FANCY OUTPUT --- */
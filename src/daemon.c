@@ -0,0 +1,330 @@
+/*
+ * Daemon Module
+ * -------------
+ * Author: Jaehoon, 2025
+ *
+ * One request per connection: the client writes a line, shuts down its side and reads the
+ * reply until the server closes. The server is single-threaded; every answer comes from memory
+ * except the first TOOLS probe and a config re-read, which are one git process each.
+ *
+ * The global config is stamped by inode, size and mtime of each file git reads it from.
+ * git rewrites config through a lock file and rename(), so every change gets a new inode even
+ * within the same second.
+ */
+
+#include "core.h"
+#include "daemon.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#define DAEMON_REPLY_MAX  16384
+#define DAEMON_TIMEOUT_MS 1000
+
+#ifndef _WIN32
+/* --- SOCKET --- */
+static int socket_path(char *buf, size_t size) {
+    const char *runtime = getenv("XDG_RUNTIME_DIR");
+    if (runtime && runtime[0]) snprintf(buf, size, "%s/ydjs.sock", runtime);
+    else snprintf(buf, size, "/tmp/ydjs-%ld.sock", (long)getuid());
+    return strlen(buf) < sizeof(((struct sockaddr_un *)0)->sun_path) ? 0 : -1;
+}
+
+static int socket_address(struct sockaddr_un *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    return socket_path(addr->sun_path, sizeof(addr->sun_path));
+}
+
+/* 1 if the process on the other end of 'fd' runs as our user. The socket's mode keeps other
+ * users out, but a shared /tmp lets one of them bind the path first and pose as the daemon. */
+static int peer_is_self(int fd) {
+#ifdef __linux__
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0 && cred.uid == getuid();
+#else
+    uid_t uid;
+    gid_t gid;
+    return getpeereid(fd, &uid, &gid) == 0 && uid == getuid();
+#endif
+}
+
+static void set_timeouts(int fd) {
+    struct timeval tv = { DAEMON_TIMEOUT_MS / 1000, (DAEMON_TIMEOUT_MS % 1000) * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+static int write_all(int fd, const char *data, size_t n) {
+    while (n > 0) {
+        ssize_t w = write(fd, data, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return -1;
+        data += w;
+        n -= (size_t)w;
+    }
+    return 0;
+}
+
+/* Reads until EOF (or 'size' - 1 bytes). Returns the length, -1 on error/timeout. */
+static long read_all(int fd, char *buf, size_t size) {
+    size_t len = 0;
+    while (len < size - 1) {
+        ssize_t r = read(fd, buf + len, size - 1 - len);
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0) return -1;
+        if (r == 0) break;
+        len += (size_t)r;
+    }
+    buf[len] = '\0';
+    return (long)len;
+}
+
+/* --- SERVER STATE --- */
+typedef struct {
+    int probed;
+    int git, gh;
+    char stamp[256];            /* identity of the config files the listing was read from */
+    char config[DAEMON_REPLY_MAX];
+    int config_loaded;
+} daemon_state;
+
+static void config_stamp(char *buf, size_t size) {
+    char paths[2][1024];
+    int n = 0;
+    const char *global = getenv("GIT_CONFIG_GLOBAL");
+    const char *home = getenv("HOME");
+    const char *xdg = getenv("XDG_CONFIG_HOME");
+    if (global && global[0]) {
+        snprintf(paths[n++], sizeof(paths[0]), "%s", global);
+    } else {
+        if (home) snprintf(paths[n++], sizeof(paths[0]), "%s/.gitconfig", home);
+        if (xdg && xdg[0]) snprintf(paths[n++], sizeof(paths[0]), "%s/git/config", xdg);
+        else if (home) snprintf(paths[n++], sizeof(paths[0]), "%s/.config/git/config", home);
+    }
+
+    size_t len = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < n && len < size; i++) {
+        struct stat st;
+        if (stat(paths[i], &st) != 0) len += (size_t)snprintf(buf + len, size - len, "-;");
+        else len += (size_t)snprintf(buf + len, size - len, "%lu:%ld:%ld;", (unsigned long)st.st_ino,
+                                     (long)st.st_size, (long)st.st_mtime);
+    }
+}
+
+static void refresh_config(daemon_state *state) {
+    char stamp[256];
+    config_stamp(stamp, sizeof(stamp));
+    if (state->config_loaded && strcmp(stamp, state->stamp) == 0) return;
+
+    state->config[0] = '\0';
+    FILE *fp = open_cmd("r", "git config --global --list 2>/dev/null");
+    if (fp) {
+        size_t got = fread(state->config, 1, sizeof(state->config) - 1, fp);
+        state->config[got] = '\0';
+        close_cmd(fp); /* no global config is an empty listing */
+    }
+    snprintf(state->stamp, sizeof(state->stamp), "%s", stamp);
+    state->config_loaded = 1;
+}
+
+/* Last "key=value" line of the listing wins, like 'git config --get' */
+static int config_get(const daemon_state *state, const char *key, char *value, size_t size) {
+    size_t key_len = strlen(key);
+    int found = 0;
+    for (const char *line = state->config; *line;) {
+        size_t len = strcspn(line, "\n");
+        if (len > key_len && line[key_len] == '=' && strncasecmp(line, key, key_len) == 0) {
+            snprintf(value, size, "%.*s", (int)(len - key_len - 1), line + key_len + 1);
+            found = 1;
+        }
+        line += len;
+        if (*line == '\n') line++;
+    }
+    return found;
+}
+
+/* --- SERVER --- */
+/* Builds the reply to one request. Returns 1 when the server should stop. */
+static int handle(daemon_state *state, char *request, char *reply, size_t size) {
+    request[strcspn(request, "\r\n")] = '\0';
+    char *arg = strchr(request, ' ');
+    if (arg) *arg++ = '\0';
+
+    if (strcmp(request, "PING") == 0) {
+        snprintf(reply, size, "OK %ld\n", (long)getpid());
+    } else if (strcmp(request, "TOOLS") == 0) {
+        if (!state->probed || !state->git || !state->gh) {
+            state->git = run_cmd("git --version > /dev/null 2>&1") == 0;
+            state->gh = run_cmd("gh --version > /dev/null 2>&1") == 0;
+            state->probed = 1;
+        }
+        snprintf(reply, size, "OK %d %d\n", state->git, state->gh);
+    } else if (strcmp(request, "CONFIG") == 0) {
+        refresh_config(state);
+        char value[1024];
+        if (!arg || !arg[0]) snprintf(reply, size, "OK %s", state->config);
+        else if (config_get(state, arg, value, sizeof(value))) snprintf(reply, size, "OK %s\n", value);
+        else snprintf(reply, size, "NO\n");
+    } else if (strcmp(request, "STOP") == 0) {
+        snprintf(reply, size, "OK\n");
+        return 1;
+    } else {
+        snprintf(reply, size, "ERR unknown request '%s'\n", request);
+    }
+    return 0;
+}
+
+static void serve(int listener) {
+    const char *env = getenv("DAEMON_IDLE");
+    int idle = env ? atoi(env) : DAEMON_IDLE_DEFAULT;
+    if (idle <= 0) idle = DAEMON_IDLE_DEFAULT;
+
+    daemon_state *state = calloc(1, sizeof(daemon_state));
+    static char reply[DAEMON_REPLY_MAX + 64];
+    int stop = 0;
+    while (state && !stop) {
+        struct pollfd pfd = { listener, POLLIN, 0 };
+        int ready = poll(&pfd, 1, idle * 1000);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) break; /* idle timeout */
+
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) continue;
+        if (!peer_is_self(fd)) {
+            close(fd);
+            continue;
+        }
+        set_timeouts(fd);
+        char request[1024];
+        if (read_all(fd, request, sizeof(request)) > 0) {
+            stop = handle(state, request, reply, sizeof(reply));
+            write_all(fd, reply, strlen(reply));
+        }
+        close(fd);
+    }
+    free(state);
+}
+
+/* --- PUBLIC API --- */
+int daemon_query(const char *request, char *reply, size_t size) {
+    static char buf[DAEMON_REPLY_MAX + 64];
+    struct sockaddr_un addr;
+    if (socket_address(&addr) != 0) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    set_timeouts(fd);
+
+    long len = -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0 && peer_is_self(fd) &&
+        write_all(fd, request, strlen(request)) == 0 && write_all(fd, "\n", 1) == 0) {
+        shutdown(fd, SHUT_WR);
+        len = read_all(fd, buf, sizeof(buf));
+    }
+    close(fd);
+    if (len < 2) return -1;
+
+    if (strncmp(buf, "NO", 2) == 0) return 1;
+    if (strncmp(buf, "OK", 2) != 0) return -1;
+    const char *text = buf[2] == ' ' ? buf + 3 : buf + 2;
+    size_t n = strlen(text);
+    if (n > 0 && text[n - 1] == '\n' && !strchr(text, '\n')[1]) n--; /* single-line reply */
+    if (n >= size) n = size - 1;
+    memcpy(reply, text, n);
+    reply[n] = '\0';
+    return 0;
+}
+
+int daemon_start(void) {
+    char reply[64];
+    if (daemon_query("PING", reply, sizeof(reply)) == 0) {
+        printf("Daemon already running (pid %s).\n", reply);
+        return 0;
+    }
+
+    struct sockaddr_un addr;
+    if (socket_address(&addr) != 0) {
+        fprintf(stderr, "Error: socket path too long.\n");
+        return -1;
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("socket");
+        return -1;
+    }
+    unlink(addr.sun_path); /* stale socket of a daemon that did not answer */
+    mode_t old_mask = umask(077);
+    int bound = bind(listener, (struct sockaddr *)&addr, sizeof(addr));
+    umask(old_mask);
+    if (bound != 0 || listen(listener, 16) != 0) {
+        fprintf(stderr, "Error: cannot listen on %s: %s\n", addr.sun_path, strerror(errno));
+        close(listener);
+        return -1;
+    }
+
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        close(listener);
+        unlink(addr.sun_path);
+        return -1;
+    }
+    if (pid == 0) {
+        setsid();
+        signal(SIGPIPE, SIG_IGN);
+        int null_fd = open("/dev/null", O_RDWR);
+        if (null_fd >= 0) {
+            dup2(null_fd, 0);
+            dup2(null_fd, 1);
+            dup2(null_fd, 2);
+            if (null_fd > 2) close(null_fd);
+        }
+        serve(listener);
+        close(listener);
+        unlink(addr.sun_path);
+        _exit(0);
+    }
+    close(listener);
+    printf("Daemon started (pid %ld) on %s.\n", (long)pid, addr.sun_path);
+    return 0;
+}
+
+int daemon_stop(void) {
+    char reply[64];
+    if (daemon_query("STOP", reply, sizeof(reply)) != 0) {
+        printf("No daemon running.\n");
+        return -1;
+    }
+    printf("Daemon stopped.\n");
+    return 0;
+}
+
+#else
+/* No Unix sockets in the console build: queries fail and callers do the work themselves */
+int daemon_query(const char *request, char *reply, size_t size) {
+    (void)request;
+    if (size > 0) reply[0] = '\0';
+    return -1;
+}
+
+int daemon_start(void) {
+    fprintf(stderr, "Error: the daemon is not supported on Windows.\n");
+    return -1;
+}
+
+int daemon_stop(void) {
+    return -1;
+}
+#endif
@@ -10,6 +10,20 @@
 #include "fsm_gh.h"
 #include "env_loader.h"
 #include "core.h"
+#include "stats.h"
+#include "workspace.h"
+#include "refs.h"
+#include "remote.h"
+#include "snapshot.h"
+#include "clone.h"
+#include "manifest.h"
+#include "tune.h"
+#include "bundle.h"
+#include "daemon.h"
+#include "objects.h"
+#include "status.h"
+#include "prestage.h"
+#include "worktree.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,14 +31,16 @@
 
 /* Gets git config value. Returns 1 if set, 0 if not set. Output stored in buffer. */
 static int get_git_config(const char *key, char *buffer, size_t buffer_size) {
-    char command[256];
+    char request[256];
+    snprintf(request, sizeof(request), "CONFIG %s", key);
+    int cached = daemon_query(request, buffer, buffer_size);
+    if (cached >= 0) return cached == 0;
+
     #ifdef _WIN32
-        snprintf(command, sizeof(command), "git config --global --get %s 2>nul", key);
+        FILE *fp = open_cmd("r", "git config --global --get %s 2>nul", key);
     #else
-        snprintf(command, sizeof(command), "git config --global --get %s 2>/dev/null", key);
+        FILE *fp = open_cmd("r", "git config --global --get %s 2>/dev/null", key);
     #endif
-    
-    FILE *fp = POPEN(command, "r");
     if (!fp) return 0;
     
     if (fgets(buffer, buffer_size, fp)) {
@@ -32,11 +48,11 @@ static int get_git_config(const char *key, char *buffer, size_t buffer_size) {
         while (len > 0 && (buffer[len-1] == '\n' || buffer[len-1] == '\r')) {
             buffer[--len] = '\0';
         }
-        PCLOSE(fp);
+        close_cmd(fp);
         return 1;
     }
     
-    PCLOSE(fp);
+    close_cmd(fp);
     return 0;
 }
 
@@ -78,8 +94,39 @@ static void set_git_credentials(const char *username, const char *email) {
 }
 
 
+/* Menu header line, read from HEAD in-process instead of a 'git branch' per redraw */
+static void print_current_branch(void) {
+    char branch[256];
+    if (!refs_head_branch(branch, sizeof(branch))) branch[0] = '\0'; /* detached or no repo */
+    printf("Current branch: %s\n\n", branch);
+}
+
+/* Main menu header: working-tree status instead of the bare branch (see status.h) */
+static status_panel menu_panel;
+static int menu_panel_shown;
+
+/* Returns the number of lines printed */
+static int print_menu_header(void) {
+    const char *env = getenv("STATUS_PANEL");
+    if (menu_panel_shown && !(env && strcmp(env, "0") == 0) && status_panel_refresh(&menu_panel) >= 0) {
+        return status_panel_print(&menu_panel);
+    }
+    print_current_branch();
+    return 2;
+}
+
+/* First visible option, so the cursor stays on screen when the list is taller than 'rows' */
+static int menu_first_visible(int cursor, int count, int rows) {
+    if (count <= rows) return 0;
+    int first = cursor - rows / 2;
+    if (first < 0) first = 0;
+    if (first > count - rows) first = count - rows;
+    return first;
+}
+
 /* * Generic Arrow Key Menu 
  * Returns the index of the selected option.
+ * Only the window around the cursor is drawn, so long lists (e.g. branches) stay cheap.
  */
 static int show_menu(const char *title, const char *options[], int count) {
     int selected = 0;
@@ -87,13 +134,16 @@ static int show_menu(const char *title, const char *options[], int count) {
 
     while (1) {
         clear_screen();
-        printf("Current branch: ");
-        run_cmd("git branch --show-current");
-        printf("\n");
+        int header_lines = print_menu_header();
 
         printf("=== %s ===\n\n", title);
         
-        for (int i = 0; i < count; i++) {
+        int rows = terminal_rows() - 6 - header_lines;
+        if (rows < 3) rows = 3;
+        int first = menu_first_visible(selected, count, rows);
+        int last = (first + rows < count) ? first + rows : count;
+        if (first > 0) printf("     ... %d more above\n", first);
+        for (int i = first; i < last; i++) {
             if (i == selected) {
                 #ifdef _WIN32
                 printf("  -> %s\n", options[i]);
@@ -104,6 +154,7 @@ static int show_menu(const char *title, const char *options[], int count) {
                 printf("     %s\n", options[i]);
             }
         }
+        if (last < count) printf("     ... %d more below\n", count - last);
 
         key = get_key();
 
@@ -119,6 +170,62 @@ static int show_menu(const char *title, const char *options[], int count) {
     }
 }
 
+/* * Multi-select Arrow Key Menu
+ * Space toggles the highlighted option, 'a' selects/clears all, Enter confirms.
+ * 'checked' holds the initial selection and receives the final one.
+ * Returns the number of checked options.
+ */
+static int show_multi_menu(const char *title, const char *options[], int count, char *checked) {
+    int cursor = 0;
+    int key;
+
+    while (1) {
+        int checked_count = 0;
+        for (int i = 0; i < count; i++) checked_count += checked[i] ? 1 : 0;
+
+        clear_screen();
+        print_current_branch();
+
+        printf("=== %s ===\n", title);
+        printf("[Space] toggle  [a] all/none  [Enter] confirm  (%d of %d selected)\n\n", checked_count, count);
+
+        int rows = terminal_rows() - 9;
+        if (rows < 3) rows = 3;
+        int first = menu_first_visible(cursor, count, rows);
+        int last = (first + rows < count) ? first + rows : count;
+        if (first > 0) printf("     ... %d more above\n", first);
+        for (int i = first; i < last; i++) {
+            if (i == cursor) {
+                #ifdef _WIN32
+                printf("  -> [%c] %s\n", checked[i] ? 'x' : ' ', options[i]);
+                #else
+                printf("\033[7m  -> [%c] %s \033[0m\n", checked[i] ? 'x' : ' ', options[i]);
+                #endif
+            } else {
+                printf("     [%c] %s\n", checked[i] ? 'x' : ' ', options[i]);
+            }
+        }
+        if (last < count) printf("     ... %d more below\n", count - last);
+
+        key = get_key();
+
+        if (key == KEY_UP) {
+            cursor--;
+            if (cursor < 0) cursor = count - 1;
+        } else if (key == KEY_DOWN) {
+            cursor++;
+            if (cursor >= count) cursor = 0;
+        } else if (key == ' ') {
+            checked[cursor] = !checked[cursor];
+        } else if (key == 'a') {
+            char value = (checked_count == count) ? 0 : 1;
+            for (int i = 0; i < count; i++) checked[i] = value;
+        } else if (key == KEY_ENTER) {
+            return checked_count;
+        }
+    }
+}
+
 /* --- LOGIC DEFINITIONS --- */
 
 const char *SEMANTIC_TYPES[] = {
@@ -139,7 +246,185 @@ const char *SCOPES[] = {
     "auth", "api", "ui", "db", "cli", "build", "infra", "none"
 };
 
+/* Deletes every local branch except those checked out (in any worktree) and '_cache_' snapshots */
+static void prune_local_branches(void) {
+    const char *keep[] = { "_cache_" };
+    int deleted = refs_prune_branches(keep, 1);
+    if (deleted < 0) {
+        printf("Warning: failed to prune local branches.\n");
+    } else {
+        printf("Pruned %d local branch(es).\n", deleted);
+    }
+}
+
 /* --- ACTION HELPERS --- */
+static object_db session_objects;
+static int session_objects_open;
+
+/* The cat-file coprocess of the repository in the current directory, kept for the whole
+ * session; it is restarted only when the current directory changes. */
+static object_db *session_db(void) {
+    char cwd[1024];
+    if (!GET_CWD(cwd, sizeof(cwd))) cwd[0] = '\0';
+    if (session_objects_open && strcmp(session_objects.dir, cwd) == 0) return &session_objects;
+    if (session_objects_open) objects_close(&session_objects);
+    objects_open(&session_objects, cwd[0] ? cwd : NULL);
+    session_objects_open = 1;
+    return &session_objects;
+}
+
+static void session_db_close(void) {
+    if (session_objects_open) objects_close(&session_objects);
+    session_objects_open = 0;
+}
+
+enum { PICK_BACK, PICK_BRANCH, PICK_FILTER };
+
+/* Branch picker over an ls-remote listing. Each branch is tagged from the local
+ * refs/remotes/origin/ and refs/prefetch/ indexes (one binary search each per branch):
+ *   [new]         never fetched
+ *   [updated]     origin moved since the last fetch
+ *   [prefetched]  origin moved, but the background prefetch already has it
+ *   [fetched]     tracking ref already matches, no fetch needed
+ * Tips that are already local show their commit subject, read through the session's cat-file coprocess.
+ * Returns PICK_BRANCH with the branch name in 'target' and its remote oid in 'oid',
+ * PICK_FILTER or PICK_BACK. */
+static int pick_remote_branch(const ref_list *heads, const char *default_branch, const char *pattern,
+                              char *target, size_t target_size, char *oid_out) {
+    ref_index tracking, prefetched;
+    if (ref_index_open(&tracking, "refs/remotes/origin/") != 0) {
+        printf("Error: could not read the tracking refs.\n");
+        pausef(NULL);
+        return PICK_BACK;
+    }
+    ref_index_open(&prefetched, "refs/prefetch/remotes/origin/"); /* on failure lookups just miss */
+
+    enum { LABEL_MAX = REF_NAME_MAX + 32 + OBJECT_SUBJECT_MAX };
+    int extra = 3; /* origin/HEAD, filter, back */
+    int count = heads->count + extra;
+    const char **options = malloc(sizeof(char *) * count);
+    char (*labels)[LABEL_MAX] = malloc(sizeof(*labels) * count);
+    char (*subjects)[OBJECT_SUBJECT_MAX] = calloc(heads->count + 1, sizeof(*subjects));
+    if (!options || !labels || !subjects) {
+        free(options);
+        free(labels);
+        free(subjects);
+        ref_index_close(&tracking);
+        ref_index_close(&prefetched);
+        return PICK_BACK;
+    }
+
+    /* Subjects are a nicety: without them the labels are just shorter */
+    for (int i = 0; i < heads->count; i++) options[i] = heads->items[i].oid;
+    objects_subjects(session_db(), options, heads->count, subjects);
+
+    snprintf(labels[0], LABEL_MAX, "origin/HEAD -> %s", default_branch[0] ? default_branch : "(unknown)");
+    if (pattern[0]) snprintf(labels[1], LABEL_MAX, "Filter: '%s' (change)", pattern);
+    else snprintf(labels[1], LABEL_MAX, "Filter by pattern...");
+    for (int i = 0; i < heads->count; i++) {
+        const char *branch = heads->items[i].name + strlen("refs/heads/");
+        char name[REF_NAME_MAX + 32], oid[REF_OID_MAX];
+        const char *tag = "[new]";
+        snprintf(name, sizeof(name), "refs/remotes/origin/%s", branch);
+        if (ref_index_lookup(&tracking, name, oid, sizeof(oid))) {
+            tag = strcmp(oid, heads->items[i].oid) == 0 ? "[fetched]" : "[updated]";
+        }
+        if (strcmp(tag, "[fetched]") != 0) {
+            snprintf(name, sizeof(name), "refs/prefetch/remotes/origin/%s", branch);
+            if (ref_index_lookup(&prefetched, name, oid, sizeof(oid)) && strcmp(oid, heads->items[i].oid) == 0) {
+                tag = "[prefetched]";
+            }
+        }
+        if (subjects[i][0]) snprintf(labels[i + 2], LABEL_MAX, "%-12s origin/%-30s %s", tag, branch, subjects[i]);
+        else snprintf(labels[i + 2], LABEL_MAX, "%-12s origin/%s", tag, branch);
+    }
+    snprintf(labels[count - 1], LABEL_MAX, "Back to menu");
+    for (int i = 0; i < count; i++) options[i] = labels[i];
+    ref_index_close(&tracking);
+    ref_index_close(&prefetched);
+
+    char title[160];
+    snprintf(title, sizeof(title), "Checkout Branch (%d on origin%s%s)",
+             heads->count, pattern[0] ? " matching " : "", pattern);
+    int choice = show_menu(title, options, count);
+
+    int result = PICK_BRANCH;
+    oid_out[0] = '\0';
+    if (choice == 0) {
+        char name[REF_NAME_MAX + 16];
+        snprintf(name, sizeof(name), "refs/heads/%s", default_branch);
+        const ref_entry *head = default_branch[0] ? refs_find(heads, name) : NULL;
+        if (head) {
+            snprintf(target, target_size, "%s", default_branch);
+            snprintf(oid_out, REF_OID_MAX, "%s", head->oid);
+        } else {
+            printf("Error: origin has no HEAD branch.\n");
+            result = PICK_BACK;
+        }
+    } else if (choice == 1) {
+        result = PICK_FILTER;
+    } else if (choice == count - 1) {
+        result = PICK_BACK;
+    } else {
+        snprintf(target, target_size, "%s", heads->items[choice - 2].name + strlen("refs/heads/"));
+        snprintf(oid_out, REF_OID_MAX, "%s", heads->items[choice - 2].oid);
+    }
+
+    free(options);
+    free(labels);
+    free(subjects);
+    return result;
+}
+
+/* Runs the pre-stage scan and lets the user leave flagged files out (all checked by default).
+ * Writes the staging command into 'command'; falls back to 'git add .' when the scan is
+ * off or fails. */
+static void review_staging(char *command, size_t size) {
+    snprintf(command, size, "git add .");
+    const char *env = getenv("PRESTAGE");
+    if (env && strcmp(env, "0") == 0) return;
+
+    prestage_report report;
+    int hits = prestage_scan(&report);
+    if (hits < 0) {
+        printf("Warning: pre-stage scan failed; staging everything.\n");
+        return;
+    }
+    if (hits > 0) {
+        enum { LABEL_MAX = 320 };
+        const char **options = malloc(sizeof(char *) * hits);
+        char (*labels)[LABEL_MAX] = malloc(sizeof(*labels) * hits);
+        char *excluded = malloc(hits);
+        if (options && labels && excluded) {
+            for (int i = 0; i < hits; i++) {
+                const prestage_hit *hit = &report.hits[i];
+                const char *why = hit->reasons == (PRESTAGE_LARGE | PRESTAGE_BINARY) ? "large binary"
+                                : hit->reasons == PRESTAGE_LARGE ? "large" : "binary";
+                snprintf(labels[i], LABEL_MAX, "%9.1f MiB  %-12s %s", hit->size / (1024.0 * 1024.0), why, hit->path);
+                options[i] = labels[i];
+                /* Only oversize files start checked; small binaries (icons, images) are usually
+                 * meant to be committed, so leaving them out is the user's call */
+                excluded[i] = (hit->reasons & PRESTAGE_LARGE) != 0;
+            }
+            char title[160];
+            snprintf(title, sizeof(title), "Leave out of this commit? (%d of %d changed files flagged, %.0f ms)",
+                     hits, report.scanned, report.scan_ms);
+            if (show_multi_menu(title, options, hits, excluded) > 0) {
+                if (prestage_command(&report, excluded, command, size) != 0) {
+                    printf("Warning: could not write the exclude list; staging everything.\n");
+                    snprintf(command, size, "git add .");
+                } else {
+                    printf("Left out files stay in the working tree; add them to .gitignore or 'git lfs track' them.\n");
+                }
+            }
+        }
+        free(options);
+        free(labels);
+        free(excluded);
+    }
+    prestage_free(&report);
+}
+
 static void action_push(void);
 static void action_fetch(void);
 static void action_commit(void);
@@ -176,6 +461,8 @@ int state_exit() {
     printf("|   To contact the author: jsong421@gatech.edu              |\n");
     printf("|                                                           |\n");
     printf("+===========================================================+\n");
+    session_db_close();
+    if (stats_enabled()) stats_print_summary();
     pausef(NULL);
 
     // // nayun edition
@@ -211,32 +498,32 @@ int state_exit() {
 
 /* State 0: Start (Check Tools & Git Credentials) */
 int state_start() {
+    stats_set_flow("setup");
     clear_screen();
     printf("Checking dependencies...\n");
     
-    /* Check Git */
-    int git_status;
-    #ifdef _WIN32
-        git_status = system("git --version > nul 2>&1");
-    #else
-        git_status = system("git --version > /dev/null 2>&1");
-    #endif
+    /* A running daemon answers from its cached probes */
+    char tools[32];
+    int git_ok = 0, gh_ok = 0;
+    if (daemon_query("TOOLS", tools, sizeof(tools)) != 0 || sscanf(tools, "%d %d", &git_ok, &gh_ok) != 2) {
+        #ifdef _WIN32
+            git_ok = run_cmd("git --version > nul 2>&1") == 0;
+            gh_ok = git_ok && run_cmd("gh --version > nul 2>&1") == 0;
+        #else
+            git_ok = run_cmd("git --version > /dev/null 2>&1") == 0;
+            gh_ok = git_ok && run_cmd("gh --version > /dev/null 2>&1") == 0;
+        #endif
+    }
 
-    if (git_status != 0) {
+    /* Check Git */
+    if (!git_ok) {
         printf("Error: 'git' is not installed or not in PATH.\n");
         pausef(NULL);
         return -1;
     }
 
     /* Check Github CLI */
-    int gh_status;
-    #ifdef _WIN32
-        gh_status = system("gh --version > nul 2>&1");
-    #else
-        gh_status = system("gh --version > /dev/null 2>&1");
-    #endif
-
-    if (gh_status != 0) {
+    if (!gh_ok) {
         printf("Error: 'gh' (GitHub CLI) is not installed.\n");
         pausef(NULL);
         return -1;
@@ -355,7 +642,14 @@ int state_start() {
     clear_screen();
     printf("Current Git Global Configuration:\n");
     printf("-----------------------------------\n");
-    run_cmd("git config --global --list");
+    char *listing = malloc(16384);
+    if (listing && daemon_query("CONFIG", listing, 16384) == 0) {
+        size_t len = strlen(listing);
+        printf("%s%s", listing, (len > 0 && listing[len - 1] != '\n') ? "\n" : "");
+    } else {
+        run_cmd("git config --global --list");
+    }
+    free(listing);
     printf("-----------------------------------\n\n");
     
     printf("Do you want to change credentials? (y/n): ");
@@ -431,40 +725,143 @@ int state_check_repo() {
 }
 
 /* State 2: Initialize Repo */
+/* Per-entry sync plan of state_init() */
+typedef struct {
+    manifest m;             /* wanted */
+    manifest applied;       /* as of the last sync */
+    int *changes;           /* MANIFEST_* bits per entry */
+    clone_profile *profiles;
+    char *needs_clone;      /* missing or interrupted clone */
+    char *applied_ok;       /* entry is (now) in sync */
+    int to_clone, to_update;
+} sync_plan;
+
+static void free_plan(sync_plan *plan) {
+    free(plan->changes);
+    free(plan->profiles);
+    free(plan->needs_clone);
+    free(plan->applied_ok);
+    manifest_free(&plan->applied);
+    manifest_free(&plan->m);
+}
+
+/* Lists every entry with what will happen to it and asks for confirmation. Returns 1 on 'y'. */
+static int confirm_sync(const sync_plan *plan) {
+    printf("Found %d repositories, %d to clone, %d changed:\n", plan->m.count, plan->to_clone, plan->to_update);
+    for (int i = 0; i < plan->m.count; i++) {
+        const manifest_entry *entry = &plan->m.entries[i];
+        int changes = plan->changes[i];
+        char profile_text[768];
+        clone_describe(&plan->profiles[i], profile_text, sizeof(profile_text));
+        printf("  [%d] %s -> %s [%s]", i + 1, entry->url, entry->path, profile_text);
+        if (entry->group[0]) printf(" (group %s)", entry->group);
+        if (plan->needs_clone[i] && ACCESS(entry->path) == 0) {
+            printf(" (interrupted, will resume)");
+        } else if (plan->needs_clone[i]) {
+            printf(" (new)");
+        } else if (!plan->applied_ok[i]) {
+            printf(" (changed:%s%s%s)", (changes & MANIFEST_URL) ? " url" : "",
+                   (changes & MANIFEST_BRANCH) ? " branch" : "", (changes & MANIFEST_OPTIONS) ? " options" : "");
+        } else {
+            printf(" (up to date)");
+        }
+        printf("\n");
+    }
+
+    if (plan->to_update == 0) {
+        printf("\nDo you want to clone all repositories to the current directory? (y/n): ");
+    } else {
+        printf("\nClone %d and update %d repositories in the current directory? (y/n): ",
+               plan->to_clone, plan->to_update);
+    }
+    char answer[8];
+    get_input_string(answer, sizeof(answer));
+    return answer[0] == 'y' || answer[0] == 'Y';
+}
+
+/* Updates the changed clones in place, then clones the missing ones (journaled, so an
+ * interrupted run resumes). Marks what succeeded in applied_ok. Returns the failed count. */
+static int apply_sync(sync_plan *plan) {
+    int count = plan->m.count, failed = 0;
+    if (plan->to_update > 0) {
+        printf("Applying manifest changes...\n\n");
+        for (int i = 0; i < count; i++) {
+            if (plan->needs_clone[i] || plan->applied_ok[i]) continue;
+            const manifest_entry *entry = &plan->m.entries[i];
+            if (manifest_update_repo(entry, manifest_find(&plan->applied, entry->path), plan->changes[i]) == 0) {
+                plan->applied_ok[i] = 1;
+            } else {
+                printf("Error: could not update %s.\n", entry->path);
+                failed++;
+            }
+        }
+        printf("\n");
+    }
+    if (plan->to_clone == 0) return failed;
+
+    printf("Cloning repositories...\n\n");
+    const char **urls = calloc(plan->to_clone, sizeof(char *));
+    const char **paths = calloc(plan->to_clone, sizeof(char *));
+    clone_profile *profiles = calloc(plan->to_clone, sizeof(clone_profile));
+    int *priorities = calloc(plan->to_clone, sizeof(int));
+    if (!urls || !paths || !profiles || !priorities) {
+        failed += plan->to_clone;
+    } else {
+        int n = 0;
+        for (int i = 0; i < count; i++) {
+            if (!plan->needs_clone[i]) continue;
+            urls[n] = plan->m.entries[i].url;
+            paths[n] = plan->m.entries[i].path;
+            priorities[n] = plan->m.entries[i].priority;
+            profiles[n++] = plan->profiles[i];
+        }
+        failed += clone_all(urls, paths, profiles, priorities, n);
+
+        clone_journal journal;
+        clone_journal_load(&journal);
+        for (int i = 0; i < count; i++) {
+            const journal_entry *entry = clone_journal_find(&journal, plan->m.entries[i].path);
+            if (plan->needs_clone[i] && entry && entry->state == CLONE_VERIFIED) plan->applied_ok[i] = 1;
+        }
+        clone_journal_free(&journal);
+    }
+    free(urls);
+    free(paths);
+    free(profiles);
+    free(priorities);
+    return failed;
+}
+
 int state_init() {
-    /* Check for URLS and REPO_NAMES in .env */
-    int url_count = 0, repo_name_count = 0;
-    char **urls = get_env("URLS", ";", &url_count);
-    char **repo_names = get_env("REPO_NAMES", ";", &repo_name_count);
-    
-    /* Case 1: URLS or REPO_NAMES missing or empty */
-    if (!urls || url_count == 0 || !repo_names || repo_name_count == 0) {
+    stats_set_flow("clone");
+
+    /* Workspace definition: ydjs.manifest, else URLS / REPO_NAMES / CLONE_OPTIONS in .env */
+    sync_plan plan;
+    char error[512];
+    memset(&plan, 0, sizeof(plan));
+    if (manifest_load(&plan.m, error, sizeof(error)) != 0) {
         clear_screen();
-        printf("Error: URLS and REPO_NAMES not found in .env file.\n");
-        printf("Please add to .env:\n");
+        printf("Error: %s.\n", error);
+        printf("Please add a %s with one '<path> <url> [options]' line per repo, or to .env:\n", MANIFEST_FILE);
         printf("URLS=\"\"\n");
         printf("REPO_NAMES=\"\"\n");
         pausef(NULL);
-        
-        if (urls) free_env(urls, url_count);
-        if (repo_names) free_env(repo_names, repo_name_count);
         return -1; /* Exit */
     }
-    
-    /* Case 2: Count mismatch */
-    if (url_count != repo_name_count) {
-        clear_screen();
-        printf("Error: Mismatch between URLS (%d) and REPO_NAMES (%d) count.\n", 
-               url_count, repo_name_count);
-        printf("Please fix .env file so they have the same number of elements.\n");
-        pausef(NULL);
-        
-        free_env(urls, url_count);
-        free_env(repo_names, repo_name_count);
-        return -1; /* Exit */
+    manifest_load_file(&plan.applied, MANIFEST_APPLIED, error, sizeof(error)); /* unreadable = nothing applied */
+
+    int count = plan.m.count;
+    plan.changes = calloc(count, sizeof(int));
+    plan.profiles = calloc(count, sizeof(clone_profile));
+    plan.needs_clone = calloc(count, 1);
+    plan.applied_ok = calloc(count, 1);
+    if (!plan.changes || !plan.profiles || !plan.needs_clone || !plan.applied_ok) {
+        free_plan(&plan);
+        return -1;
     }
-    
-    /* Case 3: Valid URLS and REPO_NAMES - check if already cloned */
+    manifest_diff(&plan.m, &plan.applied, plan.changes);
+    for (int i = 0; i < count; i++) manifest_profile(&plan.m.entries[i], &plan.profiles[i]);
+
     clear_screen();
     char cwd[1024];
     if (GET_CWD(cwd, sizeof(cwd)) != NULL) {
@@ -472,79 +869,64 @@ int state_init() {
     } else {
         printf("Current directory: (error getting directory)\n\n");
     }
-    
-    /* Check if all repos are already cloned */
-    int all_cloned = 1;
-    for (int i = 0; i < url_count; i++) {
-        if (ACCESS(repo_names[i]) != 0) {
-            all_cloned = 0;
-            break;
+
+    /* Only act on what changed: missing clones (an interrupted one does not count) and
+     * existing clones whose entry differs from the applied manifest */
+    clone_journal journal;
+    clone_journal_load(&journal);
+    for (int i = 0; i < count; i++) {
+        if (!clone_is_complete(&journal, plan.m.entries[i].path)) {
+            plan.needs_clone[i] = 1;
+            plan.to_clone++;
+        } else if (plan.changes[i] & ~MANIFEST_NEW) {
+            plan.to_update++;
+        } else {
+            plan.applied_ok[i] = 1; /* unchanged, or cloned before it was in the manifest */
         }
     }
-    
-    if (all_cloned) {
+    clone_journal_free(&journal);
+
+    if (plan.to_clone == 0 && plan.to_update == 0) {
         printf("All repositories are already initialized.\n");
-        printf("Found %d repositories:\n", url_count);
-        for (int i = 0; i < url_count; i++) {
-            printf("  [%d] %s\n", i + 1, repo_names[i]);
+        printf("Found %d repositories:\n", count);
+        for (int i = 0; i < count; i++) {
+            printf("  [%d] %s\n", i + 1, plan.m.entries[i].path);
+        }
+        manifest_save_applied(&plan.m, &plan.applied, plan.applied_ok);
+
+        printf("\nSync them with their remotes (fetch + fast-forward clean checkouts)? (y/n): ");
+        char answer[8];
+        get_input_string(answer, sizeof(answer));
+        if (answer[0] == 'y' || answer[0] == 'Y') {
+            clear_screen();
+            workspace_sync();
         }
         lazyprintf("Next: Exiting");
         pausef(NULL);
-        
-        free_env(urls, url_count);
-        free_env(repo_names, repo_name_count);
-        return -1; /* Exit */
-    }
-    
-    /* Some repos need to be cloned - show list and prompt */
-    printf("Found %d repositories to clone:\n", url_count);
-    for (int i = 0; i < url_count; i++) {
-        int exists = (ACCESS(repo_names[i]) == 0);
-        printf("  [%d] %s -> %s", i + 1, urls[i], repo_names[i]);
-        if (exists) {
-            printf(" (already exists)");
-        }
-        printf("\n");
-    }
-    
-    printf("\nDo you want to clone all repositories to the current directory? (y/n): ");
-    char answer[8];
-    get_input_string(answer, sizeof(answer));
-    
-    if (answer[0] != 'y' && answer[0] != 'Y') {
-        printf("Cloning cancelled.\n");
-        free_env(urls, url_count);
-        free_env(repo_names, repo_name_count);
-        return -1; /* Exit */
-    }
-    
-    /* Clone all repositories */
-    clear_screen();
-    printf("Cloning repositories...\n\n");
-    for (int i = 0; i < url_count; i++) {
-        /* Skip if already exists */
-        if (ACCESS(repo_names[i]) == 0) {
-            printf("[%d/%d] %s already exists, skipping...\n", i + 1, url_count, repo_names[i]);
-            continue;
+    } else if (!confirm_sync(&plan)) {
+        printf("Cancelled.\n");
+    } else {
+        clear_screen();
+        int failed = apply_sync(&plan);
+        manifest_save_applied(&plan.m, &plan.applied, plan.applied_ok);
+        if (failed == 0) {
+            printf("All repositories are in sync with the manifest!\n");
+        } else {
+            printf("%d of %d repositories could not be synced. Run again to resume.\n",
+                   failed, plan.to_clone + plan.to_update);
         }
-        printf("[%d/%d] Cloning %s into %s...\n", i + 1, url_count, urls[i], repo_names[i]);
-        run_cmd("git clone \"%s\" \"%s\"", urls[i], repo_names[i]);
-        printf("\n");
+        lazyprintf("Next: Exiting");
+        pausef(NULL);
     }
-    
-    printf("All repositories cloned successfully!\n");
-    lazyprintf("Next: Exiting");
-    pausef(NULL);
-    
-    free_env(urls, url_count);
-    free_env(repo_names, repo_name_count);
-    
+
+    free_plan(&plan);
     /* Exit after cloning */
     return -1;
 }
 
 /* Action: PUSH Flow */
 static void action_push() {
+    stats_set_flow("push");
     char branch[100];
     char title[200];
     char full_title[512];
@@ -562,10 +944,31 @@ static void action_push() {
         return;
     }
     
-    run_cmd("git checkout -b %s", branch);
+    /* Worktree mode: the branch gets its own checkout (reused on later pushes), the main one stays put */
+    char home[1024] = "";
+    if (worktree_mode()) {
+        char dir[1024];
+        int entered = worktree_enter(branch, dir, sizeof(dir));
+        if (entered == 0 && (!GET_CWD(home, sizeof(home)) || CHANGE_DIR(dir) != 0)) {
+            home[0] = '\0';
+            entered = -1;
+        }
+        if (entered < 0) {
+            printf("Error: could not prepare a worktree for '%s'.\n", branch);
+            lazyprintf("Next: Returning to main menu");
+            pausef(NULL);
+            return;
+        }
+    } else {
+        run_cmd("git checkout -b %s", branch);
+    }
     
-    /* 2. Commit All Changes */
-    run_cmd("git add .");
+    /* 2. Stage All Changes (minus what the scan flagged and the user left out),
+     * in the background while the user picks type, scope and title */
+    char stage_cmd[1400];
+    review_staging(stage_cmd, sizeof(stage_cmd));
+    bg_cmd staging;
+    bg_start(&staging, 0, "%s", stage_cmd);
     
     /* 3. Semantic Selection */
     int type_idx = show_menu("Select Type", SEMANTIC_TYPES, 11);
@@ -589,7 +992,9 @@ static void action_push() {
         sprintf(full_title, "%s(%s): %s", type_str, scope_str, title);
     }
 
-    /* 4. Commit */
+    /* 4. Commit, once staging has finished */
+    if (!bg_done(&staging)) printf("Waiting for staging to finish...\n");
+    if (bg_join(&staging) != 0) run_cmd("%s", stage_cmd); /* rerun in the foreground to show the error */
     run_cmd("git commit -m \"%s\"", full_title);
 
     /* 5. Push and PR */
@@ -600,46 +1005,80 @@ static void action_push() {
     run_cmd("gh pr create --title \"%s\" --body \"Auto-generated PR by ydjs\"", full_title);
     
     printf("\nDone! Push and PR creation completed.\n");
+    if (home[0]) {
+        printf("'%s' stays checked out in this worktree; later pushes to it reuse it.\n", branch);
+        CHANGE_DIR(home);
+    }
     lazyprintf("Next: Returning to main menu");
     pausef(NULL);
 }
 
 /* Action: FETCH Flow */
 static void action_fetch() {
-    char input_buf[100];
+    stats_set_flow("fetch");
     
     clear_screen();
     printf("--- FETCH FLOW ---\n");
     printf("Warning: This will hard reset local 'main' to match remote.\n");
-    lazyprintf("Force-create '_cache_' at current state and save everything");
-    run_cmd("git checkout -B _cache_");
-    run_cmd("git add .");
-    run_cmd("git commit -m \"_cache_\"");
-
+    lazyprintf("Saving a snapshot of the working tree");
+    char snapshot[REF_NAME_MAX];
+    int saved = snapshot_save(snapshot, sizeof(snapshot));
+    if (saved < 0) {
+        printf("Error: could not save a snapshot. Nothing was changed.\n");
+        lazyprintf("Next: Returning to main menu");
+        pausef(NULL);
+        return;
+    }
+    if (saved) printf("Saved everything to branch '%s'.\n", snapshot);
+    else printf("Working tree matches HEAD, no snapshot needed.\n");
 
     printf("Warning: This will delete all local branches except main/master/_cache_.\n");
     pausef(NULL);
-    run_cmd("git fetch --all --prune");
-    run_cmd("git branch | grep -v \"_cache_\" | xargs -r git branch -D");
-    lazyprintf("Fetch complete.");
-    /* Show branches */
-    printf("\nRemote branches:\n");
-    run_cmd("git branch -r");
-    printf("\nLocal branches:\n");
-    run_cmd("git branch");
+    prune_local_branches();
 
+    /* List remote heads without downloading any objects */
+    ref_list heads;
+    char default_branch[REF_NAME_MAX] = "";
+    char pattern[100] = "";
+    char target[REF_NAME_MAX] = "", target_oid[REF_OID_MAX] = "";
+    int picked;
+    remote_prefetch_join();
+    while (1) {
+        if (remote_list_heads("origin", pattern, &heads, default_branch, sizeof(default_branch)) < 0) {
+            printf("Error: could not list branches of 'origin'.\n");
+            lazyprintf("Next: Returning to main menu");
+            pausef(NULL);
+            return;
+        }
+        /* Only a full listing proves that a branch is gone */
+        if (!pattern[0]) refs_prune_remote("origin", &heads);
+        lazyprintf("Listing complete");
 
-    
-    printf("\nEnter branch name without 'origin/' to checkout (or press Enter to set on origin/HEAD locally): ");
-    get_input_string(input_buf, sizeof(input_buf));
-    
-    if (strlen(input_buf) > 0) {
-        run_cmd("git checkout %s", input_buf);
-        printf("Switched to branch: %s\n", input_buf);
-    } else {
-        run_cmd("echo $0");
-        run_cmd("bash -c \"git checkout $(git symbolic-ref refs/remotes/origin/HEAD | sed 's|.*/||')\"");
-        printf("Setting on HEAD.\n");
+        picked = pick_remote_branch(&heads, default_branch, pattern, target, sizeof(target), target_oid);
+        refs_free(&heads);
+        if (picked != PICK_FILTER) break;
+
+        printf("Pattern (e.g. 'feature/*', Enter for all branches): ");
+        get_input_string(pattern, sizeof(pattern));
+    }
+
+    if (picked == PICK_BRANCH) {
+        /* Only the branch being checked out is updated, from prefetched data when possible */
+        int synced = remote_sync_branch("origin", target, target_oid);
+        if (synced == REMOTE_CURRENT) {
+            printf("origin/%s is already up to date, skipping fetch.\n", target);
+        } else if (synced == REMOTE_PREFETCHED) {
+            printf("origin/%s updated from the background prefetch.\n", target);
+        }
+        if (synced < 0) {
+            printf("Error: could not fetch '%s' from origin.\n", target);
+        } else {
+            /* The snapshot holds the local changes, so the checkout may discard them.
+             * -B resets the local branch to origin's tip even when it is the one checked out. */
+            run_cmd("git checkout -f -B \"%s\" \"refs/remotes/origin/%s\"", target, target);
+            run_cmd("git clean -fdq");
+            printf("Switched to branch: %s\n", target);
+        }
     }
     
     lazyprintf("Next: Returning to main menu");
@@ -649,11 +1088,14 @@ static void action_fetch() {
 
 /* Action: COMMIT Flow */
 static void action_commit() {
+    stats_set_flow("commit");
     char msg[256];
     clear_screen();
     printf("--- QUICK COMMIT ---\n");
+    char stage_cmd[1400];
+    review_staging(stage_cmd, sizeof(stage_cmd));
     printf("Staging all changes...\n");
-    run_cmd("git add .");
+    run_cmd("%s", stage_cmd);
     
     printf("Enter commit message:\n");
     get_input_string(msg, sizeof(msg));
@@ -672,29 +1114,174 @@ static void action_commit() {
     pausef(NULL);
 }
 
+typedef struct {
+    const char *oid;
+    int index;
+} oid_index;
+
+static int compare_oid_index(const void *a, const void *b) {
+    return strcmp(((const oid_index *)a)->oid, ((const oid_index *)b)->oid);
+}
+
+/* Pre-selects every remote branch whose tip is an ancestor of the remote default branch.
+ * Works on the ls-remote oids: only the default branch itself is synced (if stale),
+ * then its history is streamed once and matched against the candidate tips. */
+static int select_merged(const char *default_oid, const char *default_branch,
+                         const ref_entry *candidates[], int count, char *checked) {
+    if (remote_sync_branch("origin", default_branch, default_oid) < 0) return 0;
+
+    oid_index *by_oid = malloc(sizeof(oid_index) * (count > 0 ? count : 1));
+    if (!by_oid) return 0;
+    for (int i = 0; i < count; i++) {
+        by_oid[i].oid = candidates[i]->oid;
+        by_oid[i].index = i;
+    }
+    qsort(by_oid, count, sizeof(oid_index), compare_oid_index);
+
+    int marked = 0;
+    FILE *fp = open_cmd("r", "git rev-list %s", default_oid);
+    if (fp) {
+        char line[128];
+        while (fgets(line, sizeof(line), fp)) {
+            line[strcspn(line, "\r\n")] = '\0';
+            oid_index key = { line, 0 };
+            oid_index *hit = bsearch(&key, by_oid, count, sizeof(oid_index), compare_oid_index);
+            /* Several branches can share one tip: mark all of them */
+            while (hit && hit > by_oid && strcmp(hit[-1].oid, line) == 0) hit--;
+            for (; hit && hit < by_oid + count && strcmp(hit->oid, line) == 0; hit++) {
+                if (!checked[hit->index]) {
+                    checked[hit->index] = 1;
+                    marked++;
+                }
+            }
+        }
+        close_cmd(fp);
+    }
+    free(by_oid);
+    return marked;
+}
+
 /* Action: DELETE Flow */
 static void action_delete() {
-    char branch[100];
+    stats_set_flow("delete");
     char confirm[10];
+    char pattern[100] = "";
     
     clear_screen();
-    printf("--- DELETE BRANCH ---\n");
-    run_cmd("git fetch --all --prune");
-    run_cmd("git branch | grep -v \"_cache_\" | xargs -r git branch -D");
-    run_cmd("git branch -r");
-    printf("\nEnter a remote branch (without 'origin/') name to delete:\n");
-    get_input_string(branch, sizeof(branch));
-    
-    if (strlen(branch) > 0) {
-        printf("Are you sure you want to delete '%s'? (y/n)\n", branch);
-        get_input_string(confirm, sizeof(confirm));
-        if (confirm[0] == 'y' || confirm[0] == 'Y') {
-            run_cmd("git push origin --delete %s", branch);
-            printf("Deleted.\n");
+    printf("--- DELETE BRANCHES ---\n");
+    remote_prefetch_join();
+    prune_local_branches();
+
+    char default_branch[REF_NAME_MAX] = "";
+    char preset[REF_NAME_MAX + 64];
+    const char *modes[] = { "Pick branches", preset, "Filter by pattern, then pick", "Back to menu" };
+    int mode = 0;
+    ref_list heads;
+    if (remote_list_heads("origin", NULL, &heads, default_branch, sizeof(default_branch)) < 0) {
+        printf("Error: could not list branches of 'origin'.\n");
+        pausef(NULL);
+        return;
+    }
+    refs_prune_remote("origin", &heads);
+
+    snprintf(preset, sizeof(preset), "Preset: merged into origin/%s", default_branch);
+    mode = show_menu("Delete Remote Branches", modes, 4);
+    if (mode == 2) {
+        printf("Enter a branch pattern (e.g. feature/*):\n");
+        get_input_string(pattern, sizeof(pattern));
+        refs_free(&heads);
+        if (remote_list_heads("origin", pattern, &heads, NULL, 0) < 0) {
+            printf("Error: could not list branches of 'origin'.\n");
+            pausef(NULL);
+            return;
+        }
+    }
+
+    /* Candidates: every listed branch except the default one (sorted by name) */
+    const ref_entry **candidates = malloc(sizeof(ref_entry *) * (heads.count + 1));
+    const char **names = malloc(sizeof(char *) * (heads.count + 1));
+    const char **labels = malloc(sizeof(char *) * (heads.count + 1));
+    char (*label_text)[REF_NAME_MAX + OBJECT_SUBJECT_MAX + 4] = malloc(sizeof(*label_text) * (heads.count + 1));
+    char (*subjects)[OBJECT_SUBJECT_MAX] = calloc(heads.count + 1, sizeof(*subjects));
+    char *checked = calloc(heads.count + 1, 1);
+    int count = 0;
+    const char *default_oid = NULL;
+    for (int i = 0; candidates && names && i < heads.count; i++) {
+        const char *name = heads.items[i].name + strlen("refs/heads/");
+        if (strcmp(name, default_branch) == 0) {
+            default_oid = heads.items[i].oid;
+            continue;
+        }
+        candidates[count] = &heads.items[i];
+        names[count++] = name;
+    }
+
+    if (mode == 3) {
+        /* Back to menu */
+    } else if (count == 0 || !checked) {
+        printf("No remote branches to delete (besides '%s').\n", default_branch);
+    } else {
+        int selected = 0;
+        if (mode == 1 && default_oid) select_merged(default_oid, default_branch, candidates, count, checked);
+
+        /* Label each branch with its tip's subject when the commit is local */
+        const char **menu = names;
+        if (labels && label_text && subjects) {
+            for (int i = 0; i < count; i++) labels[i] = candidates[i]->oid;
+            objects_subjects(session_db(), labels, count, subjects);
+            for (int i = 0; i < count; i++) {
+                if (subjects[i][0]) snprintf(label_text[i], sizeof(label_text[i]), "%-30s %s", names[i], subjects[i]);
+                else snprintf(label_text[i], sizeof(label_text[i]), "%s", names[i]);
+                labels[i] = label_text[i];
+            }
+            menu = labels;
+        }
+        selected = show_multi_menu("Select branches to delete", menu, count, checked);
+
+        if (selected == 0) {
+            printf("Nothing selected.\n");
         } else {
-            printf("Cancelled.\n");
+            clear_screen();
+            printf("The following %d remote branch(es) will be deleted from origin:\n", selected);
+            for (int i = 0; i < count; i++) {
+                if (checked[i]) printf("  %s\n", names[i]);
+            }
+            printf("Are you sure? (y/n)\n");
+            get_input_string(confirm, sizeof(confirm));
+            if (confirm[0] == 'y' || confirm[0] == 'Y') {
+                /* One push for all refspecs; --atomic makes it all-or-nothing (PUSH_ATOMIC=0 to disable) */
+                const char *atomic_env = getenv("PUSH_ATOMIC");
+                int atomic = !(atomic_env && strcmp(atomic_env, "0") == 0);
+                size_t size = 64;
+                for (int i = 0; i < count; i++) {
+                    if (checked[i]) size += strlen(names[i]) + 3;
+                }
+                char *cmd = malloc(size);
+                if (cmd) {
+                    size_t len = (size_t)snprintf(cmd, size, "git push%s origin --delete", atomic ? " --atomic" : "");
+                    for (int i = 0; i < count; i++) {
+                        if (checked[i]) len += (size_t)snprintf(cmd + len, size - len, " \"%s\"", names[i]);
+                    }
+                    if (run_cmd("%s", cmd) == 0) {
+                        printf("Deleted %d branch(es).\n", selected);
+                    } else {
+                        printf("Push failed; nothing was deleted%s.\n", atomic ? "" : " or only some branches were deleted");
+                    }
+                    free(cmd);
+                }
+            } else {
+                printf("Cancelled.\n");
+            }
         }
     }
+
+    free(candidates);
+    free(names);
+    free(labels);
+    free(label_text);
+    free(subjects);
+    free(checked);
+    refs_free(&heads);
     lazyprintf("Next: Returning to main menu");
     pausef(NULL);
 }
@@ -706,13 +1293,23 @@ int state_menu() {
         "Fetch  (Reset Main -> Checkout)",
         "Exit",
         "Commit (Current Branch) - admin only",
-        "Delete (Remove Branch) - admin only"
+        "Delete (Remove Branches) - admin only",
+        "Fetch All  (every repo in the workspace)",
+        "Commit All (every repo in the workspace)",
+        "Status All (every repo in the workspace)",
+        "Tune       (git performance profile)",
+        "Export Bundles (offline bootstrap seeds)"
     };
 
     // length of options
     int option_count = sizeof(options) / sizeof(options[0]);
 
+    stats_set_flow("menu");
+    remote_prefetch_start("origin");
+
+    menu_panel_shown = 1;
     int choice = show_menu("ydjs Git Helper", options, option_count);
+    menu_panel_shown = 0;
 
     switch(choice) {
         case 0: action_push(); break;
@@ -720,6 +1317,11 @@ int state_menu() {
         case 2: return -1; /* Exit */
         case 3: action_commit(); break;
         case 4: action_delete(); break;
+        case 5: workspace_fetch_all(); break;
+        case 6: workspace_commit_all(); break;
+        case 7: workspace_status_all(); break;
+        case 8: tune_action(); break;
+        case 9: bundle_export_action(); break;
     }
     
     return 3; /* Loop back to menu */
@@ -20,13 +20,35 @@
 #include "report.h"
 #include "env_loader.h"
 #include "core.h"
+#include "stats.h"
+#include "replay.h"
+#include "daemon.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 
 /* --- MAIN ENTRY --- */
 int main(int argc, char *argv[]) {
+    /* --- COMMAND LINE OPTIONS --- */
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--stats") == 0) {
+            stats_enable();     /* print per-flow child process costs on exit */
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            return replay_run(argv[i + 1], argc, argv);     /* drive a headless copy of ourselves */
+        } else if (strcmp(argv[i], "--daemon") == 0) {
+            return daemon_start() == 0 ? 0 : 1;             /* warm per-user cache, see daemon.h */
+        } else if (strcmp(argv[i], "--daemon-stop") == 0) {
+            return daemon_stop() == 0 ? 0 : 1;
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            if (input_record_start(argv[++i]) != 0) {
+                fprintf(stderr, "Error: cannot write recording to '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+    }
+
     /* --- ENVIRONMENT REPORT --- */
     print_environment_report(argc, argv);
     
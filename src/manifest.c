@@ -0,0 +1,300 @@
+/*
+ * Manifest Module
+ * ---------------
+ * Author: Jaehoon, 2025
+ *
+ * The manifest is read into one buffer and tokenised in place: every path, url, branch and
+ * group in the table points into that buffer, and the clone option tokens of each line are
+ * joined into a second area behind it (at most the size of the file again). One allocation
+ * for the strings, one for the entries.
+ */
+
+#include "core.h"
+#include "manifest.h"
+#include "env_loader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* --- LOADING --- */
+/* Checks options and duplicate paths once, so later users of the table can trust it */
+static int validate(const manifest *m, char *error, size_t error_size) {
+    for (int i = 0; i < m->count; i++) {
+        const manifest_entry *entry = &m->entries[i];
+        char reason[256];
+        clone_profile profile;
+        if (clone_parse_profile(entry->options, &profile, reason, sizeof(reason)) != 0) {
+            if (entry->line > 0) snprintf(error, error_size, "%s line %d (%s): %s", MANIFEST_FILE, entry->line, entry->path, reason);
+            else snprintf(error, error_size, "CLONE_OPTIONS entry %d (%s): %s", i + 1, entry->path, reason);
+            return -1;
+        }
+        for (int j = 0; j < i; j++) {
+            if (strcmp(m->entries[j].path, entry->path) == 0) {
+                snprintf(error, error_size, "'%s' is listed twice", entry->path);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int manifest_load_file(manifest *m, const char *file, char *error, size_t error_size) {
+    memset(m, 0, sizeof(*m));
+    if (error_size > 0) error[0] = '\0';
+    FILE *f = fopen(file, "rb");
+    if (!f) return 1;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 0) size = 0;
+    m->text = malloc((size_t)size * 2 + 2);
+    size_t got = m->text ? fread(m->text, 1, (size_t)size, f) : 0;
+    fclose(f);
+    if (!m->text) {
+        snprintf(error, error_size, "out of memory");
+        return -1;
+    }
+    m->text[got] = '\0';
+    char *options = m->text + got + 1; /* joined option tokens go here */
+
+    int lines = 1;
+    for (size_t i = 0; i < got; i++) lines += (m->text[i] == '\n');
+    m->entries = calloc((size_t)lines, sizeof(manifest_entry));
+    if (!m->entries) {
+        manifest_free(m);
+        snprintf(error, error_size, "out of memory");
+        return -1;
+    }
+
+    char *line = m->text;
+    for (int number = 1; line; number++) {
+        char *eol = strchr(line, '\n');
+        if (eol) *eol = '\0';
+
+        char *tokens[64];
+        int n = 0;
+        for (char *p = line; *p && n < 64;) {
+            while (*p && isspace((unsigned char)*p)) *p++ = '\0';
+            if (!*p || *p == '#') break;
+            tokens[n++] = p;
+            while (*p && !isspace((unsigned char)*p)) p++;
+        }
+        if (n == 1) {
+            snprintf(error, error_size, "%s line %d: expected '<path> <url> [options]'", file, number);
+            manifest_free(m);
+            return -1;
+        }
+        if (n >= 2) {
+            manifest_entry *entry = &m->entries[m->count++];
+            entry->path = tokens[0];
+            entry->url = tokens[1];
+            entry->branch = entry->group = "";
+            entry->options = options;
+            entry->line = number;
+            options[0] = '\0';
+            for (int t = 2; t < n; t++) {
+                if (strncmp(tokens[t], "branch=", 7) == 0) {
+                    entry->branch = tokens[t] + 7;
+                } else if (strncmp(tokens[t], "group=", 6) == 0) {
+                    entry->group = tokens[t] + 6;
+                } else if (strncmp(tokens[t], "priority=", 9) == 0) {
+                    entry->priority = atoi(tokens[t] + 9);
+                } else {
+                    if (options[0]) strcat(options, " ");
+                    strcat(options, tokens[t]);
+                }
+            }
+            options += strlen(options) + 1;
+        }
+        line = eol ? eol + 1 : NULL;
+    }
+
+    if (validate(m, error, error_size) != 0) {
+        manifest_free(m);
+        return -1;
+    }
+    return 0;
+}
+
+/* Legacy .env definition: URLS, REPO_NAMES and (optional) CLONE_OPTIONS paired by index */
+static int load_env(manifest *m, char *error, size_t error_size) {
+    int url_count = 0, name_count = 0, option_count = 0;
+    char **urls = get_env("URLS", ";", &url_count);
+    char **names = get_env("REPO_NAMES", ";", &name_count);
+    char **options = get_env("CLONE_OPTIONS", ";", &option_count);
+    int status = -1;
+
+    if (!urls || url_count == 0 || !names || name_count == 0) {
+        snprintf(error, error_size, "no %s, and URLS and REPO_NAMES not found in .env file", MANIFEST_FILE);
+    } else if (url_count != name_count) {
+        snprintf(error, error_size, "mismatch between URLS (%d) and REPO_NAMES (%d) count", url_count, name_count);
+    } else {
+        size_t size = 1;
+        for (int i = 0; i < url_count; i++) {
+            size += strlen(urls[i]) + strlen(names[i]) + 2;
+            if (i < option_count) size += strlen(options[i]) + 1;
+        }
+        m->text = malloc(size);
+        m->entries = calloc((size_t)url_count, sizeof(manifest_entry));
+        if (!m->text || !m->entries) {
+            snprintf(error, error_size, "out of memory");
+        } else {
+            char *p = m->text;
+            *p++ = '\0'; /* shared empty string */
+            for (int i = 0; i < url_count; i++) {
+                manifest_entry *entry = &m->entries[m->count++];
+                entry->branch = entry->group = entry->options = m->text;
+                entry->path = strcpy(p, names[i]);
+                p += strlen(p) + 1;
+                entry->url = strcpy(p, urls[i]);
+                p += strlen(p) + 1;
+                if (i < option_count) {
+                    entry->options = strcpy(p, options[i]);
+                    p += strlen(p) + 1;
+                }
+            }
+            status = validate(m, error, error_size);
+        }
+    }
+
+    if (urls) free_env(urls, url_count);
+    if (names) free_env(names, name_count);
+    if (options) free_env(options, option_count);
+    if (status != 0) manifest_free(m);
+    return status;
+}
+
+int manifest_load(manifest *m, char *error, size_t error_size) {
+    int status = manifest_load_file(m, MANIFEST_FILE, error, error_size);
+    if (status != 1) return status;
+    return load_env(m, error, error_size);
+}
+
+void manifest_free(manifest *m) {
+    free(m->entries);
+    free(m->text);
+    m->entries = NULL;
+    m->text = NULL;
+    m->count = 0;
+}
+
+/* --- QUERIES --- */
+const manifest_entry *manifest_find(const manifest *m, const char *path) {
+    for (int i = 0; i < m->count; i++) {
+        if (strcmp(m->entries[i].path, path) == 0) return &m->entries[i];
+    }
+    return NULL;
+}
+
+int manifest_profile(const manifest_entry *entry, clone_profile *profile) {
+    if (clone_parse_profile(entry->options, profile, NULL, 0) != 0) return -1;
+    if (entry->branch[0]) snprintf(profile->branch, sizeof(profile->branch), "%s", entry->branch);
+    return 0;
+}
+
+int manifest_in_groups(const manifest_entry *entry, const char *groups) {
+    if (!groups || !groups[0]) return 1;
+    size_t len = strlen(entry->group);
+    for (const char *p = groups; *p;) {
+        size_t n = strcspn(p, ",");
+        if (len > 0 && n == len && strncmp(p, entry->group, n) == 0) return 1;
+        p += n;
+        if (*p == ',') p++;
+    }
+    return 0;
+}
+
+/* --- INCREMENTAL SYNC --- */
+/* Compares what the options mean, so "default" and "" or reordered tokens are no change */
+static int same_options(const char *a, const char *b) {
+    clone_profile pa, pb;
+    if (strcmp(a, b) == 0) return 1;
+    if (clone_parse_profile(a, &pa, NULL, 0) != 0 || clone_parse_profile(b, &pb, NULL, 0) != 0) return 0;
+    return memcmp(&pa, &pb, sizeof(pa)) == 0;
+}
+
+void manifest_diff(const manifest *m, const manifest *applied, int *changes) {
+    for (int i = 0; i < m->count; i++) {
+        const manifest_entry *entry = &m->entries[i];
+        const manifest_entry *old = manifest_find(applied, entry->path);
+        changes[i] = 0;
+        if (!old) {
+            changes[i] = MANIFEST_NEW;
+            continue;
+        }
+        if (strcmp(entry->url, old->url) != 0) changes[i] |= MANIFEST_URL;
+        if (strcmp(entry->branch, old->branch) != 0) changes[i] |= MANIFEST_BRANCH;
+        if (!same_options(entry->options, old->options)) changes[i] |= MANIFEST_OPTIONS;
+    }
+}
+
+static void write_record(FILE *f, const manifest_entry *entry) {
+    fprintf(f, "%s %s", entry->path, entry->url);
+    if (entry->branch[0]) fprintf(f, " branch=%s", entry->branch);
+    if (entry->group[0]) fprintf(f, " group=%s", entry->group);
+    if (entry->priority) fprintf(f, " priority=%d", entry->priority);
+    if (entry->options[0]) fprintf(f, " %s", entry->options);
+    fprintf(f, "\n");
+}
+
+int manifest_save_applied(const manifest *m, const manifest *applied, const char *applied_ok) {
+    const char *tmp_path = MANIFEST_APPLIED ".tmp";
+    FILE *f = fopen(tmp_path, "w");
+    if (!f) return -1;
+    fprintf(f, "# Written by vcs-gh after each sync; edit %s instead.\n", MANIFEST_FILE);
+    for (int i = 0; i < m->count; i++) {
+        const manifest_entry *entry = applied_ok[i] ? &m->entries[i] : manifest_find(applied, m->entries[i].path);
+        if (entry) write_record(f, entry);
+    }
+    if (fclose(f) != 0) {
+        remove(tmp_path);
+        return -1;
+    }
+#ifdef _WIN32
+    remove(MANIFEST_APPLIED); /* rename() does not replace on Windows */
+#endif
+    return rename(tmp_path, MANIFEST_APPLIED) == 0 ? 0 : -1;
+}
+
+int manifest_update_repo(const manifest_entry *entry, const manifest_entry *old, int changes) {
+    int status = 0;
+    if (changes & MANIFEST_URL) {
+        printf("%s: origin -> %s\n", entry->path, entry->url);
+        if (run_cmd("git -C \"%s\" remote set-url origin \"%s\"", entry->path, entry->url) != 0) status = -1;
+    }
+
+    if ((changes & MANIFEST_BRANCH) && entry->branch[0]) {
+        printf("%s: switching to %s\n", entry->path, entry->branch);
+        if (run_cmd("git -C \"%s\" fetch origin \"+refs/heads/%s:refs/remotes/origin/%s\"",
+                    entry->path, entry->branch, entry->branch) != 0 ||
+            run_cmd("git -C \"%s\" checkout \"%s\"", entry->path, entry->branch) != 0) {
+            status = -1;
+        }
+    } else if (changes & MANIFEST_BRANCH) {
+        printf("%s: no branch pinned any more, staying on the current one\n", entry->path);
+    }
+
+    if (changes & MANIFEST_OPTIONS) {
+        clone_profile now, before;
+        memset(&before, 0, sizeof(before));
+        manifest_profile(entry, &now);
+        if (old) manifest_profile(old, &before);
+
+        if (strcmp(now.sparse, before.sparse) != 0) {
+            if (now.sparse[0]) {
+                printf("%s: sparse paths -> %s\n", entry->path, now.sparse);
+                if (clone_set_sparse(entry->path, &now) != 0) status = -1;
+            } else {
+                printf("%s: sparse checkout off\n", entry->path);
+                if (run_cmd("git -C \"%s\" sparse-checkout disable", entry->path) != 0) status = -1;
+            }
+        }
+        if (strcmp(now.filter, before.filter) != 0 || now.depth != before.depth ||
+            now.single_branch != before.single_branch) {
+            printf("%s: filter/depth/single-branch changes apply to new clones only\n", entry->path);
+        }
+    }
+    return status;
+}
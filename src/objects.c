@@ -0,0 +1,219 @@
+/*
+ * Object Query Module
+ * -------------------
+ * Author: Jaehoon, 2025
+ *
+ * cat-file --batch reads one name per line and answers in order:
+ *   <oid> <type> <size>\n<contents>\n
+ *   <name> missing\n
+ * Names are written in windows of at most OBJECTS_WINDOW bytes. That always fits in the pipe,
+ * so our write never blocks while git waits for us to read its answers, and git never sits
+ * idle waiting for the next name while we read.
+ *
+ * On Windows there is no coprocess: each query writes its names to a temporary file and runs
+ * one 'git cat-file' over it, which still answers the whole batch with one process.
+ */
+
+#include "core.h"
+#include "objects.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <signal.h>
+#endif
+
+#define OBJECTS_WINDOW 16384
+
+/* --- PARSING --- */
+/* Reads the message of a commit/tag body of 'size' bytes and keeps its first line */
+static void read_subject(FILE *out, long size, char *subject, size_t subject_size) {
+    size_t len = 0;
+    int prev = 0, in_message = 0, done = 0;
+    for (long i = 0; i < size; i++) {
+        int c = getc(out);
+        if (c == EOF) break;
+        if (!in_message) {
+            in_message = (c == '\n' && prev == '\n'); /* headers end at the first blank line */
+        } else if (!done) {
+            if (c == '\n' && len > 0) done = 1;
+            else if (c != '\n' && len < subject_size - 1) subject[len++] = (char)c;
+        }
+        prev = c;
+    }
+    subject[len] = '\0';
+}
+
+static void skip_bytes(FILE *out, long size) {
+    char buf[8192];
+    while (size > 0) {
+        size_t n = fread(buf, 1, size < (long)sizeof(buf) ? (size_t)size : sizeof(buf), out);
+        if (n == 0) return;
+        size -= (long)n;
+    }
+}
+
+/* Reads one answer, header and body. Returns 0 on success, -1 on EOF or an unexpected line. */
+static int read_answer(FILE *out, char *subject, size_t subject_size) {
+    char line[REF_NAME_MAX + 128], oid[REF_OID_MAX], type[16];
+    long size;
+    if (!fgets(line, sizeof(line), out)) return -1;
+    for (size_t len = strlen(line); len > 0 && line[len - 1] != '\n'; len = strlen(line)) {
+        /* A long name echoed back in a "missing" answer: read on, keeping only its tail */
+        size_t keep = len < 16 ? len : 16;
+        memmove(line, line + len - keep, keep);
+        if (!fgets(line + keep, (int)(sizeof(line) - keep), out)) return -1;
+    }
+    line[strcspn(line, "\n")] = '\0';
+
+    subject[0] = '\0';
+    if (sscanf(line, "%64s %15s %ld", oid, type, &size) != 3) {
+        size_t len = strlen(line);
+        int missing = (len > 8 && strcmp(line + len - 8, " missing") == 0) ||
+                      (len > 10 && strcmp(line + len - 10, " ambiguous") == 0);
+        return missing ? 0 : -1;
+    }
+    if (strcmp(type, "commit") == 0 || strcmp(type, "tag") == 0) read_subject(out, size, subject, subject_size);
+    else skip_bytes(out, size);
+    return getc(out) == '\n' ? 0 : -1;
+}
+
+void objects_open(object_db *db, const char *dir) {
+    memset(db, 0, sizeof(*db));
+    snprintf(db->dir, sizeof(db->dir), "%s", dir ? dir : "");
+}
+
+#ifndef _WIN32
+/* --- COPROCESSES --- */
+static int start(object_db *db, cat_file *cf) {
+    int to_child[2], from_child[2];
+    if (pipe(to_child) != 0) return -1;
+    if (pipe(from_child) != 0) {
+        close(to_child[0]);
+        close(to_child[1]);
+        return -1;
+    }
+    /* Our ends must not leak into this child or later ones */
+    fcntl(to_child[1], F_SETFD, FD_CLOEXEC);
+    fcntl(from_child[0], F_SETFD, FD_CLOEXEC);
+
+    const char *command = "exec git cat-file --batch";
+    cf->start_ms = now_ms();
+    cf->pid = spawn_shell(db->dir, command, to_child[0], from_child[1], -1);
+    close(to_child[0]);
+    close(from_child[1]);
+    cf->in = to_child[1];
+    cf->out = cf->pid > 0 ? fdopen(from_child[0], "r") : NULL;
+    if (!cf->out) {
+        close(from_child[0]);
+        close(cf->in);
+        if (cf->pid > 0) reap_child(cf->pid, command, cf->start_ms);
+        cf->pid = 0;
+        return -1;
+    }
+    return 0;
+}
+
+static void stop(cat_file *cf) {
+    if (cf->pid <= 0) return;
+    close(cf->in);      /* EOF on stdin: git finishes and exits */
+    fclose(cf->out);    /* unread answers: git gets EPIPE instead of blocking */
+    reap_child(cf->pid, "git cat-file --batch", cf->start_ms);
+    cf->pid = 0;
+}
+
+static int write_all(int fd, const char *buf, size_t len) {
+    for (size_t off = 0; off < len;) {
+        ssize_t w = write(fd, buf + off, len - off);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return -1;
+        off += (size_t)w;
+    }
+    return 0;
+}
+
+/* Writes names from 'from' on until the window is full. Returns how many, -1 on error.
+ * A name longer than the window goes alone: git reads all of it before it answers. */
+static int send_window(cat_file *cf, const char *const *names, int from, int count) {
+    char buf[OBJECTS_WINDOW];
+    size_t len = 0;
+    int sent = 0;
+    while (from + sent < count) {
+        size_t n = strlen(names[from + sent]) + 1;
+        if (len + n > sizeof(buf)) break;
+        memcpy(buf + len, names[from + sent], n - 1);
+        buf[len + n - 1] = '\n';
+        len += n;
+        sent++;
+    }
+    if (sent == 0 && from < count) {
+        const char *name = names[from];
+        return write_all(cf->in, name, strlen(name)) == 0 && write_all(cf->in, "\n", 1) == 0 ? 1 : -1;
+    }
+    return write_all(cf->in, buf, len) == 0 ? sent : -1;
+}
+
+static int query(object_db *db, const char *const *names, int count, char (*subjects)[OBJECT_SUBJECT_MAX]) {
+    cat_file *cf = &db->batch;
+    int done = 0, failures = 0;
+    void (*old_handler)(int) = signal(SIGPIPE, SIG_IGN); /* a dead coprocess must not kill us */
+    while (done < count) {
+        int sent = (cf->pid > 0 || start(db, cf) == 0) ? send_window(cf, names, done, count) : -1;
+        int got = 0;
+        while (got < sent && read_answer(cf->out, subjects[done + got], OBJECT_SUBJECT_MAX) == 0) {
+            got++;
+        }
+        done += got;
+        if (sent < 0 || got < sent) {
+            /* Died mid-batch: restart and re-send the rest, unless it fails straight away again */
+            stop(cf);
+            if (got == 0 && ++failures > 1) break;
+            cf->restarts++;
+        }
+    }
+    signal(SIGPIPE, old_handler);
+    return done == count ? 0 : -1;
+}
+
+void objects_close(object_db *db) {
+    stop(&db->batch);
+}
+
+#else
+/* One process per query, fed from a temporary file */
+static int query(object_db *db, const char *const *names, int count, char (*subjects)[OBJECT_SUBJECT_MAX]) {
+    char *list = _tempnam(NULL, "ydjs");
+    FILE *f = list ? fopen(list, "w") : NULL;
+    if (!f) {
+        free(list);
+        return -1;
+    }
+    for (int i = 0; i < count; i++) fprintf(f, "%s\n", names[i]);
+    fclose(f);
+
+    int done = 0;
+    FILE *fp = db->dir[0] ? open_cmd("rb", "git -C \"%s\" cat-file --batch < \"%s\"", db->dir, list)
+                          : open_cmd("rb", "git cat-file --batch < \"%s\"", list);
+    if (fp) {
+        while (done < count && read_answer(fp, subjects[done], OBJECT_SUBJECT_MAX) == 0) {
+            done++;
+        }
+        close_cmd(fp);
+    }
+    remove(list);
+    free(list);
+    return done == count ? 0 : -1;
+}
+
+void objects_close(object_db *db) {
+    (void)db;
+}
+#endif
+
+/* --- QUERIES --- */
+int objects_subjects(object_db *db, const char *const *names, int count, char (*subjects)[OBJECT_SUBJECT_MAX]) {
+    if (count <= 0) return 0;
+    return query(db, names, count, subjects);
+}
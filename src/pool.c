@@ -0,0 +1,211 @@
+/*
+ * Worker Pool Module
+ * ------------------
+ * Author: Jaehoon, 2025
+ *
+ * Runs a list of shell commands with bounded concurrency. Children write stdout and
+ * stderr into one pipe per job; a single poll() loop drains all pipes, so no job
+ * can block on a full pipe while another is being waited for.
+ */
+
+#include "core.h"
+#include "pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <sys/wait.h>
+#endif
+
+#define POOL_MAX_WORKERS 16
+#define POOL_MAX_OUTPUT (1024 * 1024)   /* per job; the rest is drained and dropped */
+#define POOL_TICK_MS 200                /* observer tick while jobs are quiet */
+
+int pool_default_workers(void) {
+    const char *env = getenv("PARALLEL_JOBS");
+    int workers = env ? atoi(env) : 0;
+    if (workers <= 0) workers = cpu_count();
+    if (workers > POOL_MAX_WORKERS) workers = POOL_MAX_WORKERS;
+    return workers;
+}
+
+static void append_output(pool_job *job, const char *data, size_t n) {
+    if (job->output_len + n > POOL_MAX_OUTPUT) {
+        n = POOL_MAX_OUTPUT - job->output_len;
+        if (n == 0) return;
+    }
+    char *tmp = realloc(job->output, job->output_len + n + 1);
+    if (!tmp) return;
+    job->output = tmp;
+    memcpy(job->output + job->output_len, data, n);
+    job->output_len += n;
+    job->output[job->output_len] = '\0';
+}
+
+#ifndef _WIN32
+typedef struct {
+    int job;        /* index into jobs[], -1 = free slot */
+    pid_t pid;
+    int fd;         /* read end of the job's output pipe */
+    double start_ms;
+    FILE *log;      /* job->log_path, NULL if none */
+} worker_slot;
+
+static int start_job(pool_job *job, worker_slot *slot, int index) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    int devnull = open("/dev/null", O_RDONLY);
+
+    slot->start_ms = now_ms();
+    slot->pid = spawn_shell(job->cwd, job->command, devnull, fds[1], fds[1]);
+    close(fds[1]);
+    if (devnull >= 0) close(devnull);
+    if (slot->pid < 0) {
+        close(fds[0]);
+        return -1;
+    }
+    slot->fd = fds[0];
+    slot->job = index;
+    slot->log = job->log_path[0] ? fopen(job->log_path, "wb") : NULL;
+    job->started = 1;
+    return 0;
+}
+#endif
+
+int pool_run(pool_job *jobs, int count, int max_workers) {
+    return pool_run_observed(jobs, count, max_workers, NULL, NULL);
+}
+
+int pool_run_observed(pool_job *jobs, int count, int max_workers, pool_observer observer, void *ctx) {
+    int failed = 0;
+    for (int i = 0; i < count; i++) {
+        jobs[i].exit_code = -1;
+        jobs[i].wall_ms = 0;
+        jobs[i].output = NULL;
+        jobs[i].output_len = 0;
+        jobs[i].started = 0;
+        jobs[i].finished = 0;
+    }
+
+#ifdef _WIN32
+    (void)max_workers;
+    for (int i = 0; i < count; i++) {
+        double start = now_ms();
+        FILE *fp = jobs[i].cwd[0]
+            ? open_cmd("r", "cd /d \"%s\" && %s 2>&1", jobs[i].cwd, jobs[i].command)
+            : open_cmd("r", "%s 2>&1", jobs[i].command);
+        jobs[i].started = 1;
+        if (observer) observer(jobs, count, -1, NULL, 0, ctx);
+        if (fp) {
+            FILE *log = jobs[i].log_path[0] ? fopen(jobs[i].log_path, "wb") : NULL;
+            char buf[4096];
+            size_t n;
+            while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+                append_output(&jobs[i], buf, n);
+                if (log) fwrite(buf, 1, n, log);
+                if (observer) observer(jobs, count, i, buf, n, ctx);
+            }
+            if (log) fclose(log);
+            jobs[i].exit_code = close_cmd(fp);
+        }
+        jobs[i].wall_ms = now_ms() - start;
+        jobs[i].finished = 1;
+        if (observer) observer(jobs, count, -1, NULL, 0, ctx);
+        if (jobs[i].exit_code != 0) failed++;
+    }
+    return failed;
+#else
+    if (max_workers < 1) max_workers = 1;
+    if (max_workers > count) max_workers = count;
+    if (count == 0) return 0;
+
+    worker_slot *slots = malloc(sizeof(worker_slot) * max_workers);
+    struct pollfd *pfds = malloc(sizeof(struct pollfd) * max_workers);
+    int *owners = malloc(sizeof(int) * max_workers);
+    if (!slots || !pfds || !owners) {
+        free(slots); free(pfds); free(owners);
+        return count;
+    }
+    for (int s = 0; s < max_workers; s++) slots[s].job = -1;
+
+    int next = 0, active = 0;
+    while (next < count || active > 0) {
+        /* Fill free slots */
+        for (int s = 0; s < max_workers && next < count; s++) {
+            if (slots[s].job >= 0) continue;
+            if (start_job(&jobs[next], &slots[s], next) == 0) {
+                active++;
+            } else {
+                jobs[next].finished = 1;
+                failed++;
+            }
+            next++;
+            if (observer) observer(jobs, count, -1, NULL, 0, ctx);
+        }
+        if (active == 0) continue;
+
+        int n = 0;
+        for (int s = 0; s < max_workers; s++) {
+            if (slots[s].job < 0) continue;
+            pfds[n].fd = slots[s].fd;
+            pfds[n].events = POLLIN;
+            pfds[n].revents = 0;
+            owners[n++] = s;
+        }
+        int ready = poll(pfds, n, observer ? POOL_TICK_MS : -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (ready == 0) {
+            observer(jobs, count, -1, NULL, 0, ctx);
+            continue;
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (!(pfds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            worker_slot *slot = &slots[owners[i]];
+            pool_job *job = &jobs[slot->job];
+            char buf[4096];
+            ssize_t got = read(slot->fd, buf, sizeof(buf));
+            if (got > 0) {
+                append_output(job, buf, (size_t)got);
+                if (slot->log) fwrite(buf, 1, (size_t)got, slot->log);
+                if (observer) observer(jobs, count, slot->job, buf, (size_t)got, ctx);
+                continue;
+            }
+            if (got < 0 && errno == EINTR) continue;
+
+            /* EOF: the job is done */
+            close(slot->fd);
+            int status = reap_child(slot->pid, job->command, slot->start_ms);
+            job->wall_ms = now_ms() - slot->start_ms;
+            job->exit_code = (status != -1 && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+            job->finished = 1;
+            if (slot->log) fclose(slot->log);
+            slot->log = NULL;
+            if (job->exit_code != 0) failed++;
+            slot->job = -1;
+            active--;
+            if (observer) observer(jobs, count, -1, NULL, 0, ctx);
+        }
+    }
+
+    free(slots);
+    free(pfds);
+    free(owners);
+    return failed;
+#endif
+}
+
+void pool_free(pool_job *jobs, int count) {
+    for (int i = 0; i < count; i++) {
+        free(jobs[i].output);
+        jobs[i].output = NULL;
+        jobs[i].output_len = 0;
+    }
+}
@@ -0,0 +1,244 @@
+/*
+ * Pre-stage Scan Module
+ * ---------------------
+ * Author: Jaehoon, 2025
+ *
+ *   git ls-files -z --others --exclude-standard --modified     candidates (one process)
+ *   N threads: lstat() + first 8000 bytes of each candidate     size / binary test
+ *   git check-attr -z --stdin filter < <list>                   drop hits tracked by LFS
+ * Threads take candidates in chunks from a shared cursor and write only to their own slots
+ * of the result arrays, so the cursor is the only thing behind the lock.
+ * Windows checks the candidates on the calling thread.
+ */
+
+#include "core.h"
+#include "prestage.h"
+#include "pool.h"
+#include "refs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#define BINARY_PROBE 8000       /* bytes git itself looks at */
+#define SCAN_CHUNK 32           /* candidates taken per lock */
+#define SCAN_MAX_THREADS 16
+#define LIST_FILE "ydjs-prestage"
+
+#ifdef _WIN32
+    typedef struct _stati64 file_stat;
+    #define FILE_STAT(path, st) _stati64(path, st)
+#else
+    typedef struct stat file_stat;
+    #define FILE_STAT(path, st) lstat(path, st) /* a symlink is staged as a link */
+#endif
+
+/* --- HELPERS --- */
+/* Whole output of a command; NUL bytes are kept. Returns the length, -1 on failure. */
+static long read_output(char **out, const char *command) {
+    *out = NULL;
+    FILE *fp = open_cmd("rb", "%s", command);
+    if (!fp) return -1;
+    size_t len = 0, cap = 65536;
+    char *buf = malloc(cap + 1);
+    while (buf) {
+        size_t n = fread(buf + len, 1, cap - len, fp);
+        len += n;
+        if (n == 0) break;
+        if (len == cap) {
+            char *bigger = realloc(buf, cap * 2 + 1);
+            if (!bigger) {
+                free(buf);
+                buf = NULL;
+                break;
+            }
+            buf = bigger;
+            cap *= 2;
+        }
+    }
+    if (close_cmd(fp) != 0 || !buf) {
+        free(buf);
+        return -1;
+    }
+    buf[len] = '\0';
+    *out = buf;
+    return (long)len;
+}
+
+static int list_file(char *path, size_t size) {
+    char git_dir[1024];
+    if (!refs_git_dir(git_dir, sizeof(git_dir))) return -1;
+    snprintf(path, size, "%s/%s", git_dir, LIST_FILE);
+    return 0;
+}
+
+/* --- SCANNING --- */
+typedef struct {
+    char **paths;
+    int count;
+    long long *sizes;
+    int *reasons;
+    long long limit;
+    int next;                   /* shared cursor */
+#ifndef _WIN32
+    pthread_mutex_t lock;
+#endif
+} scan_job;
+
+static void check_file(scan_job *job, int i) {
+    file_stat st;
+    if (FILE_STAT(job->paths[i], &st) != 0 || (st.st_mode & S_IFMT) != S_IFREG) return;
+    job->sizes[i] = (long long)st.st_size;
+    if (job->sizes[i] > job->limit) job->reasons[i] |= PRESTAGE_LARGE;
+    if (st.st_size == 0) return;
+
+    FILE *f = fopen(job->paths[i], "rb");
+    if (!f) return;
+    char probe[BINARY_PROBE];
+    size_t n = fread(probe, 1, sizeof(probe), f);
+    fclose(f);
+    if (memchr(probe, '\0', n)) job->reasons[i] |= PRESTAGE_BINARY;
+}
+
+#ifndef _WIN32
+static void *scan_worker(void *arg) {
+    scan_job *job = arg;
+    while (1) {
+        pthread_mutex_lock(&job->lock);
+        int first = job->next;
+        job->next += SCAN_CHUNK;
+        pthread_mutex_unlock(&job->lock);
+        if (first >= job->count) break;
+        int last = first + SCAN_CHUNK < job->count ? first + SCAN_CHUNK : job->count;
+        for (int i = first; i < last; i++) check_file(job, i);
+    }
+    return NULL;
+}
+#endif
+
+static void scan_all(scan_job *job) {
+#ifndef _WIN32
+    int threads = pool_default_workers();
+    if (threads > SCAN_MAX_THREADS) threads = SCAN_MAX_THREADS;
+    if (threads > (job->count + SCAN_CHUNK - 1) / SCAN_CHUNK) threads = (job->count + SCAN_CHUNK - 1) / SCAN_CHUNK;
+
+    pthread_t ids[SCAN_MAX_THREADS];
+    int started = 0;
+    pthread_mutex_init(&job->lock, NULL);
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&ids[started], NULL, scan_worker, job) == 0) started++;
+    }
+    scan_worker(job); /* the calling thread works too */
+    for (int t = 0; t < started; t++) pthread_join(ids[t], NULL);
+    pthread_mutex_destroy(&job->lock);
+#else
+    for (int i = 0; i < job->count; i++) check_file(job, i);
+#endif
+}
+
+/* Clears the hits whose 'filter' attribute is lfs; they are meant to be committed */
+static void drop_lfs(prestage_report *report) {
+    char file[1200];
+    if (report->count == 0 || list_file(file, sizeof(file)) != 0) return;
+    FILE *f = fopen(file, "wb");
+    if (!f) return;
+    for (int i = 0; i < report->count; i++) fwrite(report->hits[i].path, 1, strlen(report->hits[i].path) + 1, f);
+    if (fclose(f) != 0) return;
+
+    char command[1400], *output;
+    int n = snprintf(command, sizeof(command), "git check-attr -z --stdin filter < \"%s\"", file);
+    if (n < 0 || (size_t)n >= sizeof(command)) return;
+    long len = read_output(&output, command);
+    if (len < 0) return;
+
+    /* Records are <path>\0filter\0<value>\0, in input order */
+    int kept = 0, i = 0;
+    for (char *p = output; p < output + len && i < report->count; i++) {
+        char *attr = p + strlen(p) + 1;
+        char *value = attr < output + len ? attr + strlen(attr) + 1 : attr;
+        p = value < output + len ? value + strlen(value) + 1 : output + len;
+        if (value < output + len && strcmp(value, "lfs") == 0) continue;
+        report->hits[kept++] = report->hits[i];
+    }
+    for (; i < report->count; i++) report->hits[kept++] = report->hits[i];
+    report->count = kept;
+    free(output);
+}
+
+/* --- PUBLIC API --- */
+int prestage_scan(prestage_report *report) {
+    memset(report, 0, sizeof(*report));
+    double start = now_ms();
+    long len = read_output(&report->paths, "git ls-files -z --others --exclude-standard --modified");
+    if (len < 0) return -1;
+
+    int count = 0;
+    for (long i = 0; i < len; i++) count += report->paths[i] == '\0';
+
+    scan_job job;
+    memset(&job, 0, sizeof(job));
+    const char *env = getenv("PRESTAGE_MAX_MB");
+    long long mb = env ? atoll(env) : 0;
+    job.limit = (mb > 0 ? mb : PRESTAGE_MAX_MB_DEFAULT) * 1024LL * 1024LL;
+    job.paths = malloc(sizeof(char *) * (count + 1));
+    job.sizes = calloc(count + 1, sizeof(long long));
+    job.reasons = calloc(count + 1, sizeof(int));
+    report->hits = malloc(sizeof(prestage_hit) * (count + 1));
+    if (!job.paths || !job.sizes || !job.reasons || !report->hits) {
+        free(job.paths);
+        free(job.sizes);
+        free(job.reasons);
+        prestage_free(report);
+        return -1;
+    }
+    for (char *p = report->paths; p < report->paths + len; p += strlen(p) + 1) job.paths[job.count++] = p;
+
+    scan_all(&job);
+    for (int i = 0; i < job.count; i++) {
+        if (!job.reasons[i]) continue;
+        prestage_hit *hit = &report->hits[report->count++];
+        hit->path = job.paths[i];
+        hit->size = job.sizes[i];
+        hit->reasons = job.reasons[i];
+    }
+    report->scanned = job.count;
+    free(job.paths);
+    free(job.sizes);
+    free(job.reasons);
+
+    drop_lfs(report);
+    report->scan_ms = now_ms() - start;
+    return report->count;
+}
+
+void prestage_free(prestage_report *report) {
+    free(report->hits);
+    free(report->paths);
+    memset(report, 0, sizeof(*report));
+}
+
+int prestage_command(const prestage_report *report, const char *excluded, char *command, size_t size) {
+    int any = 0;
+    for (int i = 0; i < report->count; i++) any |= excluded[i] != 0;
+    if (!any) {
+        snprintf(command, size, "git add .");
+        return 0;
+    }
+
+    /* '.' plus one exclude pathspec per left-out file; literal, so '*' in a name is not a glob */
+    char file[1200];
+    if (list_file(file, sizeof(file)) != 0) return -1;
+    FILE *f = fopen(file, "wb");
+    if (!f) return -1;
+    fwrite(".", 1, 2, f);
+    for (int i = 0; i < report->count; i++) {
+        if (excluded[i]) fprintf(f, ":(exclude,literal)%s%c", report->hits[i].path, '\0');
+    }
+    if (fclose(f) != 0) return -1;
+    int n = snprintf(command, size, "git add --pathspec-from-file=\"%s\" --pathspec-file-nul", file);
+    return n >= 0 && (size_t)n < size ? 0 : -1;
+}
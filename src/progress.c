@@ -0,0 +1,228 @@
+/*
+ * Progress View Module
+ * --------------------
+ * Author: Jaehoon, 2025
+ *
+ * git writes progress to stderr as lines ending in '\r' while a phase runs and '\n' when it ends:
+ *   remote: Counting objects: 100% (120/120), done.
+ *   Receiving objects:  45% (450/1000), 1.20 MiB | 2.00 MiB/s
+ *   Resolving deltas: 100% (300/300), done.
+ *   Updating files: 100% (800/800), done.
+ * The pool hands over raw chunks, so lines are reassembled per job before parsing.
+ *
+ * A job's overall fraction weights the phases by their usual share of the wall time
+ * (download 80%, deltas 10%, checkout 10%); the ETA extrapolates the elapsed time from the
+ * average fraction of all jobs.
+ */
+
+#include "core.h"
+#include "progress.h"
+#include "refs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define REDRAW_MS 100
+
+/* --- SETUP --- */
+int progress_init(progress_view *view, const char *title, int count) {
+    memset(view, 0, sizeof(*view));
+    view->rows = calloc(count > 0 ? (size_t)count : 1, sizeof(progress_row));
+    if (!view->rows) return -1;
+    view->title = title;
+    view->count = count;
+    view->start_ms = now_ms();
+    view->drawn_ms = -REDRAW_MS;
+    return 0;
+}
+
+void progress_free(progress_view *view) {
+    free(view->rows);
+    view->rows = NULL;
+    view->count = 0;
+}
+
+int progress_log_dir(char *dir, size_t size) {
+    char git_dir[1024];
+    int n;
+    if (refs_git_dir(git_dir, sizeof(git_dir))) n = snprintf(dir, size, "%s/%s", git_dir, PROGRESS_LOG_DIR);
+    else n = snprintf(dir, size, ".%s", PROGRESS_LOG_DIR); /* the workspace root, not a working tree */
+    if (n < 0 || (size_t)n >= size) {
+        dir[0] = '\0';
+        return -1;
+    }
+    return 0;
+}
+
+int progress_log_path(const char *label, const char *kind, char *path, size_t size) {
+    char dir[1100];
+    path[0] = '\0';
+    if (progress_log_dir(dir, sizeof(dir)) != 0) return -1;
+    if (MAKE_DIR(dir) != 0 && errno != EEXIST) return -1;
+    int n = snprintf(path, size, "%s/%s.%s.log", dir, label, kind);
+    if (n < 0 || (size_t)n >= size) {
+        path[0] = '\0';
+        return -1;
+    }
+    for (char *p = path + strlen(dir) + 1; *p; p++) {
+        if (*p == '/' || *p == '\\') *p = '_'; /* nested repo paths stay one file */
+    }
+    return 0;
+}
+
+/* --- PARSING --- */
+/* "Receiving objects:  45% (450/1000), 1.20 MiB | 2.00 MiB/s" -> phase, percent, transfer.
+ * Lines without a percentage (warnings, "Cloning into ...") are ignored. */
+static void parse_line(progress_row *row, char *line) {
+    if (strncmp(line, "remote: ", 8) == 0) line += 8;
+    char *colon = strstr(line, ": ");
+    char *percent = strchr(line, '%');
+    if (!colon || !percent || percent < colon) return;
+
+    *colon = '\0';
+    snprintf(row->phase, sizeof(row->phase), "%.*s", (int)sizeof(row->phase) - 1, line);
+    row->percent = atoi(colon + 2);
+    if (row->percent > 100) row->percent = 100;
+
+    row->transfer[0] = '\0';
+    char *rest = strstr(percent, "), ");
+    if (rest) {
+        rest += 3;
+        char *done = strstr(rest, ", done");
+        if (done) *done = '\0';
+        snprintf(row->transfer, sizeof(row->transfer), "%s", rest);
+        size_t len = strlen(row->transfer);
+        while (len > 0 && row->transfer[len - 1] == ' ') row->transfer[--len] = '\0';
+    }
+}
+
+static void feed(progress_row *row, const char *data, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        char c = data[i];
+        if (c == '\r' || c == '\n') {
+            row->partial[row->partial_len] = '\0';
+            if (row->partial_len > 0) parse_line(row, row->partial);
+            row->partial_len = 0;
+        } else if (row->partial_len < sizeof(row->partial) - 1) {
+            row->partial[row->partial_len++] = c;
+        }
+    }
+}
+
+/* 0..1 for one job */
+static double job_fraction(const progress_row *row, const pool_job *job) {
+    if (job->finished) return 1.0;
+    if (!job->started) return 0.0;
+    double pct = row->percent / 100.0;
+    if (strcmp(row->phase, "Receiving objects") == 0) return 0.8 * pct;
+    if (strcmp(row->phase, "Resolving deltas") == 0) return 0.8 + 0.1 * pct;
+    if (strcmp(row->phase, "Updating files") == 0 || strcmp(row->phase, "Checking out files") == 0) {
+        return 0.9 + 0.1 * pct;
+    }
+    return 0.0; /* server-side counting/compressing */
+}
+
+/* --- RENDERING --- */
+static void format_seconds(double seconds, char *buf, size_t size) {
+    if (seconds < 60) snprintf(buf, size, "%.0fs", seconds);
+    else snprintf(buf, size, "%dm%02ds", (int)seconds / 60, (int)seconds % 60);
+}
+
+static void overall_line(const progress_view *view, const pool_job *jobs, int count, char *buf, size_t size) {
+    int done = 0, failed = 0, running = 0;
+    double sum = 0;
+    for (int i = 0; i < count; i++) {
+        if (jobs[i].finished) {
+            done++;
+            if (jobs[i].exit_code != 0) failed++;
+        } else if (jobs[i].started) {
+            running++;
+        }
+        sum += job_fraction(&view->rows[i], &jobs[i]);
+    }
+    double fraction = count > 0 ? sum / count : 1.0;
+    double elapsed = (now_ms() - view->start_ms) / 1000.0;
+
+    char elapsed_text[32], eta_text[32] = "--";
+    format_seconds(elapsed, elapsed_text, sizeof(elapsed_text));
+    if (fraction > 0.02 && fraction < 1.0) format_seconds(elapsed * (1.0 - fraction) / fraction, eta_text, sizeof(eta_text));
+
+    snprintf(buf, size, "%s: %d/%d done, %d failed, %d running | %3.0f%%  elapsed %s  ETA %s",
+             view->title, done, count, failed, running, fraction * 100.0, elapsed_text, eta_text);
+}
+
+static void row_line(const progress_row *row, const pool_job *job, char *buf, size_t size) {
+    if (!row->phase[0]) {
+        snprintf(buf, size, "  %-28.28s starting...", job->label);
+    } else {
+        snprintf(buf, size, "  %-28.28s %-20.20s %3d%%  %s", job->label, row->phase, row->percent, row->transfer);
+    }
+}
+
+/* Usable width of a status line: one short of the terminal so it never wraps and breaks the redraw */
+static int line_width(void) {
+    int width = terminal_cols() - 1;
+    return width < 1 ? 1 : width;
+}
+
+static void redraw(progress_view *view, const pool_job *jobs, int count) {
+    char line[512];
+    int width = line_width();
+#ifdef _WIN32
+    /* Jobs run one at a time there: keep a single line updated in place */
+    overall_line(view, jobs, count, line, sizeof(line));
+    printf("\r%-*.*s", width, width, line);
+#else
+    int max_rows = terminal_rows() - 4, shown = 0, hidden = 0;
+    if (max_rows < 1) max_rows = 1;
+
+    if (view->drawn_lines > 0) printf("\033[%dA", view->drawn_lines);
+    view->drawn_lines = 0;
+    for (int i = 0; i < count; i++) {
+        if (!jobs[i].started || jobs[i].finished) continue;
+        if (shown == max_rows) {
+            hidden++;
+            continue;
+        }
+        row_line(&view->rows[i], &jobs[i], line, sizeof(line));
+        printf("\033[2K%.*s\n", width, line);
+        shown++;
+    }
+    if (hidden > 0) {
+        snprintf(line, sizeof(line), "  ... %d more running", hidden);
+        printf("\033[2K%.*s\n", width, line);
+    }
+    overall_line(view, jobs, count, line, sizeof(line));
+    printf("\033[2K%.*s\n\033[J", width, line);
+    view->drawn_lines = shown + (hidden > 0) + 1;
+#endif
+    fflush(stdout);
+    view->drawn_ms = now_ms();
+}
+
+void progress_observe(const pool_job *jobs, int count, int index, const char *data, size_t n, void *ctx) {
+    progress_view *view = ctx;
+    if (index >= 0 && index < view->count) feed(&view->rows[index], data, n);
+    if (now_ms() - view->drawn_ms >= REDRAW_MS) redraw(view, jobs, count);
+}
+
+void progress_finish(progress_view *view, const pool_job *jobs, int count) {
+    int failed = 0;
+    for (int i = 0; i < count; i++) {
+        if (jobs[i].exit_code != 0) failed++;
+    }
+    char elapsed_text[32];
+    format_seconds((now_ms() - view->start_ms) / 1000.0, elapsed_text, sizeof(elapsed_text));
+#ifdef _WIN32
+    printf("\r%-*s\r", line_width(), "");
+#else
+    if (view->drawn_lines > 0) printf("\033[%dA\033[J", view->drawn_lines);
+#endif
+    view->drawn_lines = 0;
+    char log_dir[1100];
+    printf("%s: %d done, %d failed in %s.", view->title, count - failed, failed, elapsed_text);
+    if (progress_log_dir(log_dir, sizeof(log_dir)) == 0) printf(" Logs: %s/", log_dir);
+    printf("\n");
+    fflush(stdout);
+}
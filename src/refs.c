@@ -0,0 +1,671 @@
+/*
+ * Ref Access Module
+ * -----------------
+ * Author: Jaehoon, 2025
+ *
+ * Reads refs the way git stores them:
+ * - loose refs: one file per ref under <common dir>/refs/..., content "<oid>\n"
+ * - packed-refs: "<oid> <name>" lines ("#" header, "^" peeled lines are skipped), sorted
+ *   by name when the header lists the 'sorted' trait, which lets us binary-search the
+ *   mapped file instead of parsing it
+ * A loose ref always wins over a packed one with the same name.
+ */
+
+#include "core.h"
+#include "refs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+/* --- GIT DIR RESOLUTION --- */
+static void chomp(char *s) {
+    size_t len = strlen(s);
+    while (len > 0 && (s[len - 1] == '\n' || s[len - 1] == '\r' || s[len - 1] == ' ')) s[--len] = '\0';
+}
+
+static int read_first_line(const char *path, char *buf, size_t size) {
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+    int ok = fgets(buf, (int)size, f) != NULL;
+    fclose(f);
+    if (ok) chomp(buf);
+    return ok;
+}
+
+static int is_absolute(const char *path) {
+    return path[0] == '/' || path[0] == '\\' || (path[0] && path[1] == ':');
+}
+
+int refs_git_dir(char *buf, size_t size) {
+    struct stat st;
+    if (stat(".git", &st) != 0) return 0;
+    if (S_ISDIR(st.st_mode)) {
+        snprintf(buf, size, ".git");
+        return 1;
+    }
+    /* Worktrees and submodules: ".git" is a file "gitdir: <path>" */
+    char line[1024];
+    if (!read_first_line(".git", line, sizeof(line)) || strncmp(line, "gitdir: ", 8) != 0) return 0;
+    snprintf(buf, size, "%s", line + 8);
+    return 1;
+}
+
+int refs_common_dir(char *buf, size_t size) {
+    char git_dir[1024], path[1100], line[1024];
+    if (!refs_git_dir(git_dir, sizeof(git_dir))) return 0;
+    snprintf(path, sizeof(path), "%s/commondir", git_dir);
+    if (read_first_line(path, line, sizeof(line))) {
+        if (is_absolute(line)) snprintf(buf, size, "%s", line);
+        else snprintf(buf, size, "%s/%s", git_dir, line);
+    } else {
+        snprintf(buf, size, "%s", git_dir);
+    }
+    return 1;
+}
+
+/* --- REF LIST --- */
+int refs_add(ref_list *list, const char *name, const char *oid) {
+    if (strlen(name) >= REF_NAME_MAX || strlen(oid) >= REF_OID_MAX) return 0; /* not representable */
+    if (list->count >= list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 256;
+        ref_entry *tmp = realloc(list->items, sizeof(ref_entry) * capacity);
+        if (!tmp) return -1;
+        list->items = tmp;
+        list->capacity = capacity;
+    }
+    snprintf(list->items[list->count].name, REF_NAME_MAX, "%s", name);
+    snprintf(list->items[list->count].oid, REF_OID_MAX, "%s", oid);
+    list->count++;
+    return 0;
+}
+
+static int compare_ref(const void *a, const void *b) {
+    return strcmp(((const ref_entry *)a)->name, ((const ref_entry *)b)->name);
+}
+
+void refs_sort(ref_list *list) {
+    if (list->count > 1) qsort(list->items, list->count, sizeof(ref_entry), compare_ref);
+}
+
+const ref_entry *refs_find(const ref_list *list, const char *name) {
+    ref_entry key;
+    if (list->count == 0 || strlen(name) >= REF_NAME_MAX) return NULL;
+    snprintf(key.name, sizeof(key.name), "%s", name);
+    return bsearch(&key, list->items, list->count, sizeof(ref_entry), compare_ref);
+}
+
+/* Recursively collects loose refs below 'dir' (which holds the refs named 'name_prefix...'). */
+static int walk_loose(const char *dir, const char *name_prefix, ref_list *list) {
+    DIR *d = opendir(dir);
+    if (!d) return 0;
+    struct dirent *ent;
+    int rc = 0;
+    while (rc == 0 && (ent = readdir(d)) != NULL) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+        size_t len = strlen(ent->d_name);
+        if (len > 5 && strcmp(ent->d_name + len - 5, ".lock") == 0) continue;
+
+        char path[2048], name[2048];
+        snprintf(path, sizeof(path), "%s/%s", dir, ent->d_name);
+        snprintf(name, sizeof(name), "%s%s", name_prefix, ent->d_name);
+
+        struct stat st;
+        if (stat(path, &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            strncat(name, "/", sizeof(name) - strlen(name) - 1);
+            rc = walk_loose(path, name, list);
+            continue;
+        }
+        char oid[128];
+        if (!read_first_line(path, oid, sizeof(oid))) continue;
+        if (strncmp(oid, "ref:", 4) == 0) continue; /* symbolic ref, e.g. origin/HEAD */
+        rc = refs_add(list, name, oid);
+    }
+    closedir(d);
+    return rc;
+}
+
+/* --- PACKED-REFS INDEX --- */
+/* Records are "<oid> <name>\n", each optionally followed by a peeled "^<oid>\n" line.
+ * Positions are moved to record boundaries the way git's own packed-refs reader does. */
+static const char *record_start(const char *lo, const char *p) {
+    while (p > lo && (p[-1] != '\n' || p[0] == '^')) p--;
+    return p;
+}
+
+static const char *record_end(const char *p, const char *end) {
+    while (++p < end && (p[-1] != '\n' || p[0] == '^'))
+        ;
+    return p;
+}
+
+/* Compares the name of the record at 'rec' with 'name' (strcmp order) */
+static int compare_record(const char *rec, const char *end, const char *name) {
+    const char *p = memchr(rec, ' ', (size_t)(end - rec));
+    if (!p) return -1;
+    for (p++; p < end && *p != '\n' && *p != '\r'; p++, name++) {
+        if (*name == '\0') return 1;
+        if (*p != *name) return (unsigned char)*p < (unsigned char)*name ? -1 : 1;
+    }
+    return *name == '\0' ? 0 : -1;
+}
+
+/* Parses the record at 'rec'. Returns 1 if it holds a ref, 0 for malformed lines. */
+static int parse_record(const char *rec, const char *end, char *name, char *oid) {
+    const char *space = memchr(rec, ' ', (size_t)(end - rec));
+    const char *eol = memchr(rec, '\n', (size_t)(end - rec));
+    if (!eol) eol = end;
+    if (!space || space > eol) return 0;
+    size_t oid_len = (size_t)(space - rec), name_len = (size_t)(eol - space - 1);
+    if (name_len > 0 && space[name_len] == '\r') name_len--;
+    if (oid_len >= REF_OID_MAX || name_len >= REF_NAME_MAX) return 0;
+    memcpy(oid, rec, oid_len);
+    oid[oid_len] = '\0';
+    memcpy(name, space + 1, name_len);
+    name[name_len] = '\0';
+    return 1;
+}
+
+/* First record whose name is >= 'name' (the end of the data if none) */
+static const char *lower_bound(const ref_index *index, const char *name) {
+    const char *lo = index->data + index->body, *hi = index->data + index->size;
+    const char *end = hi;
+    while (lo < hi) {
+        const char *mid = lo + (hi - lo) / 2;
+        const char *rec = record_start(lo, mid);
+        int cmp = compare_record(rec, end, name);
+        if (cmp < 0) lo = record_end(mid, hi);
+        else if (cmp > 0) hi = rec;
+        else return rec;
+    }
+    return lo;
+}
+
+static int load_packed(ref_index *index, const char *path) {
+#ifdef _WIN32
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size <= 0 || !(index->data = malloc((size_t)size))) {
+        fclose(f);
+        return size <= 0 ? 0 : -1;
+    }
+    index->size = fread(index->data, 1, (size_t)size, f);
+    fclose(f);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return 0;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); /* the mapping stays valid; git replaces packed-refs by rename, never in place */
+    if (map == MAP_FAILED) return -1;
+    index->data = map;
+    index->size = (size_t)st.st_size;
+    index->mapped = 1;
+#endif
+    return 0;
+}
+
+static void release_packed(ref_index *index) {
+    if (index->data) {
+#ifdef _WIN32
+        free(index->data);
+#else
+        if (index->mapped) munmap(index->data, index->size);
+        else free(index->data);
+#endif
+    }
+    index->data = NULL;
+    index->size = 0;
+    index->body = 0;
+}
+
+int ref_index_open(ref_index *index, const char *prefix) {
+    char common[1024], path[2048];
+    memset(index, 0, sizeof(*index));
+    snprintf(index->prefix, sizeof(index->prefix), "%s", prefix);
+    if (!refs_common_dir(common, sizeof(common))) return -1;
+
+    /* 1. Loose refs; a prefix like "refs/heads/_cache_" is matched within its directory */
+    char dir_prefix[REF_NAME_MAX];
+    snprintf(dir_prefix, sizeof(dir_prefix), "%s", prefix);
+    char *slash = strrchr(dir_prefix, '/');
+    if (slash) slash[1] = '\0';
+    snprintf(path, sizeof(path), "%s/%s", common, dir_prefix);
+    size_t plen = strlen(path);
+    if (plen > 0 && path[plen - 1] == '/') path[plen - 1] = '\0';
+    if (walk_loose(path, dir_prefix, &index->loose) != 0) {
+        ref_index_close(index);
+        return -1;
+    }
+    if (strcmp(dir_prefix, prefix) != 0) {
+        int kept = 0;
+        for (int i = 0; i < index->loose.count; i++) {
+            if (strncmp(index->loose.items[i].name, prefix, strlen(prefix)) == 0) {
+                index->loose.items[kept++] = index->loose.items[i];
+            }
+        }
+        index->loose.count = kept;
+    }
+    refs_sort(&index->loose);
+
+    /* 2. packed-refs, searched in place when git declared it sorted */
+    snprintf(path, sizeof(path), "%s/packed-refs", common);
+    if (load_packed(index, path) != 0) {
+        ref_index_close(index);
+        return -1;
+    }
+    if (!index->data) return 0;
+
+    const char *data = index->data, *end = data + index->size;
+    int sorted = 0;
+    if (index->size > 1 && data[0] == '#') {
+        const char *eol = memchr(data, '\n', index->size);
+        if (!eol) eol = end;
+        for (const char *p = data; p + 8 <= eol; p++) {
+            if (memcmp(p, " sorted", 7) == 0 && (p[7] == ' ' || p[7] == '\n' || p[7] == '\r')) sorted = 1;
+        }
+        index->body = (eol < end) ? (size_t)(eol - data) + 1 : index->size;
+    }
+    if (sorted) return 0;
+
+    /* Unsorted (very old writers): parse every record once and sort them */
+    for (const char *rec = data + index->body; rec < end; rec = record_end(rec, end)) {
+        char name[REF_NAME_MAX], oid[REF_OID_MAX];
+        if (*rec == '#' || !parse_record(rec, end, name, oid)) continue;
+        if (refs_add(&index->unsorted, name, oid) != 0) {
+            ref_index_close(index);
+            return -1;
+        }
+    }
+    refs_sort(&index->unsorted);
+    release_packed(index);
+    return 0;
+}
+
+void ref_index_close(ref_index *index) {
+    release_packed(index);
+    refs_free(&index->unsorted);
+    refs_free(&index->loose);
+}
+
+int ref_index_lookup(const ref_index *index, const char *name, char *oid, size_t size) {
+    const ref_entry *hit = refs_find(&index->loose, name);
+    if (!hit) hit = refs_find(&index->unsorted, name);
+    if (hit) {
+        snprintf(oid, size, "%s", hit->oid);
+        return 1;
+    }
+    if (!index->data) return 0;
+
+    const char *end = index->data + index->size;
+    const char *rec = lower_bound(index, name);
+    char found[REF_NAME_MAX], packed_oid[REF_OID_MAX];
+    if (rec >= end || !parse_record(rec, end, found, packed_oid) || strcmp(found, name) != 0) return 0;
+    snprintf(oid, size, "%s", packed_oid);
+    return 1;
+}
+
+int ref_index_list(const ref_index *index, ref_list *list) {
+    const char *end = index->data ? index->data + index->size : NULL;
+    const char *rec = end;
+    size_t prefix_len = strlen(index->prefix);
+    int u = 0, l = 0, start = list->count;
+
+    if (index->data) {
+        rec = lower_bound(index, index->prefix);
+    } else {
+        while (u < index->unsorted.count && strcmp(index->unsorted.items[u].name, index->prefix) < 0) u++;
+    }
+
+    /* Merge the packed range with the loose refs; both are sorted */
+    while (1) {
+        char name[REF_NAME_MAX], oid[REF_OID_MAX];
+        int have_packed = 0;
+        if (!index->data) {
+            if (u < index->unsorted.count) {
+                snprintf(name, sizeof(name), "%s", index->unsorted.items[u].name);
+                snprintf(oid, sizeof(oid), "%s", index->unsorted.items[u].oid);
+                have_packed = 1;
+            }
+        } else {
+            while (rec < end && !parse_record(rec, end, name, oid)) rec = record_end(rec, end);
+            have_packed = rec < end;
+        }
+        if (have_packed && strncmp(name, index->prefix, prefix_len) != 0) have_packed = 0;
+
+        const ref_entry *loose = (l < index->loose.count) ? &index->loose.items[l] : NULL;
+        if (!have_packed && !loose) break;
+
+        int cmp = !have_packed ? 1 : !loose ? -1 : strcmp(name, loose->name);
+        int rc;
+        if (cmp < 0) {
+            rc = refs_add(list, name, oid);
+        } else {
+            rc = refs_add(list, loose->name, loose->oid);
+            l++;
+        }
+        if (rc != 0) return -1;
+        if (cmp <= 0) {
+            if (index->data) rec = record_end(rec, end);
+            else u++;
+        }
+    }
+    return list->count - start;
+}
+
+int refs_list(const char *prefix, ref_list *list) {
+    ref_index index;
+    list->items = NULL;
+    list->count = 0;
+    list->capacity = 0;
+    if (ref_index_open(&index, prefix) != 0) return -1;
+    int count = ref_index_list(&index, list);
+    ref_index_close(&index);
+    if (count < 0) refs_free(list);
+    return count;
+}
+
+void refs_free(ref_list *list) {
+    free(list->items);
+    list->items = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+int refs_head_branch(char *buf, size_t size) {
+    char git_dir[1024], path[1100], line[1024];
+    if (!refs_git_dir(git_dir, sizeof(git_dir))) return 0;
+    snprintf(path, sizeof(path), "%s/HEAD", git_dir);
+    if (!read_first_line(path, line, sizeof(line))) return 0;
+    if (strncmp(line, "ref: refs/heads/", 16) != 0) return 0;
+    snprintf(buf, size, "%s", line + 16);
+    return 1;
+}
+
+int refs_remote_default_branch(const char *remote, char *buf, size_t size) {
+    char common[1024], path[1400], line[1024], prefix[200];
+    if (!refs_common_dir(common, sizeof(common))) return 0;
+
+    /* refs/remotes/<remote>/HEAD is a symbolic ref written by clone / 'remote set-head' */
+    snprintf(path, sizeof(path), "%s/refs/remotes/%s/HEAD", common, remote);
+    snprintf(prefix, sizeof(prefix), "ref: refs/remotes/%s/", remote);
+    if (read_first_line(path, line, sizeof(line)) && strncmp(line, prefix, strlen(prefix)) == 0) {
+        snprintf(buf, size, "%s", line + strlen(prefix));
+        return 1;
+    }
+
+    /* No symref: fall back to the usual names */
+    const char *candidates[] = { "main", "master" };
+    ref_index index;
+    snprintf(prefix, sizeof(prefix), "refs/remotes/%s/", remote);
+    if (ref_index_open(&index, prefix) != 0) return 0;
+    int found = 0;
+    for (int c = 0; c < 2 && !found; c++) {
+        char name[REF_NAME_MAX], oid[REF_OID_MAX];
+        snprintf(name, sizeof(name), "%s%s", prefix, candidates[c]);
+        if (ref_index_lookup(&index, name, oid, sizeof(oid))) {
+            snprintf(buf, size, "%s", candidates[c]);
+            found = 1;
+        }
+    }
+    ref_index_close(&index);
+    return found;
+}
+
+/* --- BRANCH PRUNING --- */
+/* Rewrites <common>/config without the [branch "..."] sections of deleted branches,
+ * under config.lock like git itself. Failure only leaves stale sections behind. */
+static void drop_branch_sections(const char *common, const ref_list *heads, const char *deleted) {
+    char path[1100], lock_path[1200];
+    snprintf(path, sizeof(path), "%s/config", common);
+    snprintf(lock_path, sizeof(lock_path), "%s/config.lock", common);
+
+    struct stat st;
+    FILE *in = fopen(path, "r");
+    if (!in) return;
+    if (fstat(fileno(in), &st) != 0) st.st_mode = 0644;
+    int lock_fd = open(lock_path, O_WRONLY | O_CREAT | O_EXCL, st.st_mode & 0777);
+    if (lock_fd < 0) {
+        fclose(in);
+        return;
+    }
+#ifndef _WIN32
+    fchmod(lock_fd, st.st_mode & 07777); /* like git: the rename must not change the config's mode */
+#endif
+    FILE *out = fdopen(lock_fd, "w");
+    if (!out) {
+        close(lock_fd);
+        remove(lock_path);
+        fclose(in);
+        return;
+    }
+
+    char line[4096];
+    int dropping = 0, dropped = 0, escaped = 0;
+    while (fgets(line, sizeof(line), in)) {
+        const char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '[') {
+            dropping = 0;
+            if (strncmp(p, "[branch \"", 9) == 0) {
+                const char *end = strstr(p + 9, "\"]");
+                if (end && memchr(p + 9, '\\', (size_t)(end - (p + 9)))) {
+                    escaped = 1; /* left to git, which knows the quoting rules */
+                } else if (end) {
+                    ref_entry key;
+                    snprintf(key.name, sizeof(key.name), "refs/heads/%.*s", (int)(end - (p + 9)), p + 9);
+                    ref_entry *hit = bsearch(&key, heads->items, heads->count, sizeof(ref_entry), compare_ref);
+                    if (hit && deleted[hit - heads->items]) dropping = 1;
+                }
+            }
+        }
+        if (dropping) {
+            dropped = 1;
+            continue;
+        }
+        fputs(line, out);
+    }
+    fclose(in);
+
+    if (fclose(out) != 0 || !dropped) {
+        remove(lock_path);
+    } else {
+#ifdef _WIN32
+        remove(path);
+#endif
+        if (rename(lock_path, path) != 0) remove(lock_path);
+    }
+    if (!escaped) return;
+
+    /* Sections with escapes in their name: one 'git config' per deleted branch that needs them */
+    for (int i = 0; i < heads->count; i++) {
+        const char *branch = heads->items[i].name + strlen("refs/heads/");
+        if (!deleted[i] || !strpbrk(branch, "\"\\")) continue;
+        char quoted[REF_NAME_MAX * 2], *q = quoted;
+        for (const char *c = branch; *c; c++) {
+            if (strchr("\"\\$`", *c)) *q++ = '\\';
+            *q++ = *c;
+        }
+        *q = '\0';
+        run_cmd("git config --remove-section \"branch.%s\" 2>%s", quoted, NULL_DEVICE);
+    }
+}
+
+int refs_delete_flagged(const ref_list *list, const char *flags) {
+    FILE *fp = NULL;
+    int count = 0;
+    for (int i = 0; i < list->count; i++) {
+        if (!flags[i]) continue;
+        if (!fp) fp = open_cmd("w", "git update-ref --stdin");
+        if (!fp) return -1;
+        /* Old value guards against deleting a ref that moved since we read it */
+        fprintf(fp, "delete %s %s\n", list->items[i].name, list->items[i].oid);
+        count++;
+    }
+    if (fp && close_cmd(fp) != 0) return -1; /* the transaction was rolled back as a whole */
+    return count;
+}
+
+/* --- WORKTREES --- */
+/* Branch in '<git_dir>/HEAD', "" if detached, unreadable or too long for 'branch' */
+static void worktree_head(const char *git_dir, char *branch, size_t size) {
+    char path[1400], line[1024];
+    branch[0] = '\0';
+    snprintf(path, sizeof(path), "%s/HEAD", git_dir);
+    if (read_first_line(path, line, sizeof(line)) && strncmp(line, "ref: refs/heads/", 16) == 0) {
+        int n = snprintf(branch, size, "%s", line + 16);
+        if (n < 0 || (size_t)n >= size) branch[0] = '\0'; /* a cut name would match the wrong branch */
+    }
+}
+
+/* Visits the main worktree and every linked one: git dir, and the directory checked out there.
+ * Stops when 'visit' returns non-zero and returns that value. */
+typedef int (*worktree_visit)(const char *git_dir, const char *dir, void *ctx);
+
+static int each_worktree(worktree_visit visit, void *ctx) {
+    char common[1024], main_dir[1100], base[1100];
+    if (!refs_common_dir(common, sizeof(common))) return -1;
+    /* The main worktree is the parent of the common dir ('<dir>/.git'). Inside a linked
+     * worktree that is '<dir>/.git/worktrees/<name>/../..', so it is normalised first. */
+    if (absolute_path(common, main_dir, sizeof(main_dir)) != 0) return -1;
+    char *slash = strrchr(main_dir, '/');
+    if (!slash) slash = strrchr(main_dir, '\\');
+    if (!slash) return -1;
+    if (slash == main_dir) slash[1] = '\0'; /* '/.git' */
+    else *slash = '\0';
+    int result = visit(common, main_dir, ctx);
+    if (result) return result;
+
+    snprintf(base, sizeof(base), "%s/worktrees", common);
+    DIR *d = opendir(base);
+    if (!d) return 0;
+    struct dirent *ent;
+    while (!result && (ent = readdir(d)) != NULL) {
+        if (ent->d_name[0] == '.') continue;
+        char git_dir[1400], path[1500], dir[1024];
+        snprintf(git_dir, sizeof(git_dir), "%s/%s", base, ent->d_name);
+        /* '<git_dir>/gitdir' holds the path of the worktree's '.git' file */
+        snprintf(path, sizeof(path), "%s/gitdir", git_dir);
+        if (!read_first_line(path, dir, sizeof(dir))) continue;
+        size_t len = strlen(dir);
+        if (len >= 5 && strcmp(dir + len - 5, "/.git") == 0) dir[len - 5] = '\0';
+        result = visit(git_dir, dir, ctx);
+    }
+    closedir(d);
+    return result;
+}
+
+static int add_head(const char *git_dir, const char *dir, void *ctx) {
+    char branch[REF_NAME_MAX], name[REF_NAME_MAX + 16];
+    (void)dir;
+    worktree_head(git_dir, branch, sizeof(branch));
+    if (!branch[0]) return 0;
+    snprintf(name, sizeof(name), "refs/heads/%s", branch);
+    return refs_add(ctx, name, "") < 0 ? -1 : 0;
+}
+
+int refs_worktree_heads(ref_list *list) {
+    memset(list, 0, sizeof(*list));
+    if (each_worktree(add_head, list) < 0) {
+        refs_free(list);
+        return -1;
+    }
+    refs_sort(list);
+    return list->count;
+}
+
+typedef struct {
+    const char *branch;
+    char *path;
+    size_t size;
+} worktree_query;
+
+static int match_head(const char *git_dir, const char *dir, void *ctx) {
+    worktree_query *query = ctx;
+    char branch[REF_NAME_MAX];
+    worktree_head(git_dir, branch, sizeof(branch));
+    if (strcmp(branch, query->branch) != 0) return 0;
+    snprintf(query->path, query->size, "%s", dir);
+    return 1;
+}
+
+int refs_worktree_path(const char *branch, char *path, size_t size) {
+    worktree_query query = { branch, path, size };
+    return each_worktree(match_head, &query) == 1;
+}
+
+int refs_prune_branches(const char *keep[], int keep_count) {
+    ref_list heads, checked_out;
+    if (refs_list("refs/heads/", &heads) < 0) return -1;
+    if (refs_worktree_heads(&checked_out) < 0) {
+        refs_free(&heads);
+        return -1;
+    }
+
+    char current[REF_NAME_MAX] = "";
+    refs_head_branch(current, sizeof(current));
+
+    char *deleted = calloc(heads.count > 0 ? heads.count : 1, 1);
+    if (!deleted) {
+        refs_free(&heads);
+        refs_free(&checked_out);
+        return -1;
+    }
+
+    for (int i = 0; i < heads.count; i++) {
+        const char *branch = heads.items[i].name + strlen("refs/heads/");
+        if (strcmp(branch, current) == 0) continue;
+        if (refs_find(&checked_out, heads.items[i].name)) continue; /* HEAD of another worktree */
+        int keep_it = 0;
+        for (int k = 0; k < keep_count && !keep_it; k++) {
+            if (strstr(branch, keep[k])) keep_it = 1;
+        }
+        if (!keep_it) deleted[i] = 1;
+    }
+
+    int count = refs_delete_flagged(&heads, deleted);
+    if (count > 0) {
+        char common[1024];
+        if (refs_common_dir(common, sizeof(common))) drop_branch_sections(common, &heads, deleted);
+    }
+
+    free(deleted);
+    refs_free(&heads);
+    refs_free(&checked_out);
+    return count;
+}
+
+int refs_prune_remote(const char *remote, const ref_list *live_heads) {
+    char prefix[REF_NAME_MAX];
+    ref_list tracking;
+    snprintf(prefix, sizeof(prefix), "refs/remotes/%s/", remote);
+    if (refs_list(prefix, &tracking) < 0) return -1;
+
+    char *stale = calloc(tracking.count > 0 ? tracking.count : 1, 1);
+    if (!stale) {
+        refs_free(&tracking);
+        return -1;
+    }
+    for (int i = 0; i < tracking.count; i++) {
+        char head[REF_NAME_MAX + 16];
+        snprintf(head, sizeof(head), "refs/heads/%s", tracking.items[i].name + strlen(prefix));
+        if (!refs_find(live_heads, head)) stale[i] = 1;
+    }
+    int count = refs_delete_flagged(&tracking, stale);
+
+    free(stale);
+    refs_free(&tracking);
+    return count;
+}
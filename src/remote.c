@@ -0,0 +1,173 @@
+/*
+ * Remote Query Module
+ * -------------------
+ * Author: Jaehoon, 2025
+ *
+ * 'git ls-remote --symref <remote> HEAD refs/heads/<pattern>' prints:
+ *   ref: refs/heads/main<TAB>HEAD
+ *   <oid><TAB>HEAD
+ *   <oid><TAB>refs/heads/<branch>
+ * which is read as a stream, so huge listings never sit in memory twice.
+ *
+ * Objects are pulled in by a low-priority background prefetch while the user is idle, so
+ * most branch updates become a local 'update-ref' instead of a download.
+ */
+
+#include "core.h"
+#include "remote.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+int remote_list_heads(const char *remote, const char *pattern, ref_list *heads,
+                      char *default_branch, size_t default_size) {
+    heads->items = NULL;
+    heads->count = 0;
+    heads->capacity = 0;
+    if (default_branch && default_size > 0) default_branch[0] = '\0';
+
+    FILE *fp = open_cmd("r", "git ls-remote --symref %s HEAD \"refs/heads/%s\"",
+                        remote, (pattern && pattern[0]) ? pattern : "*");
+    if (!fp) return -1;
+
+    char line[1024];
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char *tab = strchr(line, '\t');
+        if (!tab) continue;
+        *tab = '\0';
+        const char *name = tab + 1;
+
+        if (strncmp(line, "ref: refs/heads/", 16) == 0 && strcmp(name, "HEAD") == 0) {
+            if (default_branch) snprintf(default_branch, default_size, "%s", line + 16);
+        } else if (strncmp(name, "refs/heads/", 11) == 0) {
+            if (refs_add(heads, name, line) != 0) break;
+        }
+    }
+
+    if (close_cmd(fp) != 0) {
+        refs_free(heads);
+        return -1;
+    }
+    refs_sort(heads);
+    return heads->count;
+}
+
+int remote_fetch_branch(const char *remote, const char *branch) {
+    return run_cmd("git fetch %s \"+refs/heads/%s:refs/remotes/%s/%s\"", remote, branch, remote, branch);
+}
+
+/* 1 if the ref 'prefix' + 'branch' exists and points at 'oid' */
+static int ref_matches(const char *prefix, const char *branch, const char *oid) {
+    ref_index index;
+    char name[REF_NAME_MAX * 2], found[REF_OID_MAX];
+    if (ref_index_open(&index, prefix) != 0) return 0;
+    snprintf(name, sizeof(name), "%s%s", prefix, branch);
+    int match = ref_index_lookup(&index, name, found, sizeof(found)) && strcmp(found, oid) == 0;
+    ref_index_close(&index);
+    return match;
+}
+
+int remote_sync_branch(const char *remote, const char *branch, const char *oid) {
+    char prefix[REF_NAME_MAX];
+    snprintf(prefix, sizeof(prefix), "refs/remotes/%s/", remote);
+    if (ref_matches(prefix, branch, oid)) return REMOTE_CURRENT;
+
+    snprintf(prefix, sizeof(prefix), "refs/prefetch/remotes/%s/", remote);
+    if (ref_matches(prefix, branch, oid) &&
+        run_cmd("git update-ref \"refs/remotes/%s/%s\" %s", remote, branch, oid) == 0) {
+        return REMOTE_PREFETCHED;
+    }
+
+    return remote_fetch_branch(remote, branch) == 0 ? REMOTE_FETCHED : -1;
+}
+
+/* --- FETCH FRESHNESS --- */
+int remote_freshness_window(void) {
+    const char *env = getenv("FETCH_FRESHNESS");
+    return (env && env[0]) ? atoi(env) : 300;
+}
+
+static int stamp_path(const char *remote, char *path, size_t size) {
+    char git_dir[1024];
+    if (!refs_git_dir(git_dir, sizeof(git_dir))) return 0;
+    snprintf(path, size, "%s/ydjs-fetched-%s", git_dir, remote);
+    return 1;
+}
+
+double remote_fetch_age(const char *remote) {
+    char path[1400];
+    long long stamp = 0;
+    if (!stamp_path(remote, path, sizeof(path))) return -1;
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    int ok = fscanf(f, "%lld", &stamp) == 1;
+    fclose(f);
+    if (!ok) return -1;
+    double age = difftime(time(NULL), (time_t)stamp);
+    return age < 0 ? 0 : age; /* clock went backwards: treat as just fetched */
+}
+
+void remote_mark_fetched(const char *remote) {
+    char path[1400];
+    if (!stamp_path(remote, path, sizeof(path))) return;
+    FILE *f = fopen(path, "w");
+    if (!f) return;
+    fprintf(f, "%lld\n", (long long)time(NULL));
+    fclose(f);
+}
+
+int remote_tips_match(const char *remote, const char *ls_remote_output) {
+    char prefix[REF_NAME_MAX];
+    ref_list tracking;
+    snprintf(prefix, sizeof(prefix), "refs/remotes/%s/", remote);
+    if (!ls_remote_output || refs_list(prefix, &tracking) < 0) return 0;
+
+    int match = 1, advertised = 0;
+    const char *line = ls_remote_output;
+    while (match && *line) {
+        const char *eol = strchr(line, '\n');
+        size_t len = eol ? (size_t)(eol - line) : strlen(line);
+        const char *tab = memchr(line, '\t', len);
+        if (tab && len - (size_t)(tab + 1 - line) > 11 && strncmp(tab + 1, "refs/heads/", 11) == 0) {
+            char name[REF_NAME_MAX * 2];
+            snprintf(name, sizeof(name), "%s%.*s", prefix, (int)(len - (size_t)(tab + 12 - line)), tab + 12);
+            name[strcspn(name, "\r")] = '\0';
+            const ref_entry *local = refs_find(&tracking, name);
+            size_t oid_len = (size_t)(tab - line);
+            if (!local || strlen(local->oid) != oid_len || strncmp(local->oid, line, oid_len) != 0) match = 0;
+            advertised++;
+        }
+        if (!eol) break;
+        line = eol + 1;
+    }
+    if (advertised != tracking.count) match = 0; /* a branch was deleted on the remote */
+    refs_free(&tracking);
+    return match;
+}
+
+/* --- BACKGROUND PREFETCH --- */
+static bg_cmd prefetch;
+static double prefetch_started_ms = -1;
+
+void remote_prefetch_start(const char *remote) {
+#ifdef _WIN32
+    (void)remote; /* bg_start() would block the menu there */
+#else
+    const char *env = getenv("PREFETCH_INTERVAL");
+    double interval_s = env ? atof(env) : 300;
+    if (interval_s <= 0) return;
+    if (!bg_done(&prefetch)) return;
+    if (prefetch_started_ms >= 0 && now_ms() - prefetch_started_ms < interval_s * 1000) return;
+
+    prefetch_started_ms = now_ms();
+    bg_start(&prefetch, 19, "git fetch --prefetch --prune --no-tags --no-write-fetch-head --quiet %s", remote);
+#endif
+}
+
+void remote_prefetch_join(void) {
+    if (bg_done(&prefetch)) return;
+    printf("Waiting for the background prefetch to finish...\n");
+    bg_join(&prefetch);
+}
@@ -0,0 +1,302 @@
+/*
+ * Keystroke Record/Replay Module
+ * ------------------------------
+ * Author: Jaehoon, 2025
+ *
+ * Records raw input with timestamps and replays it through a pseudo-terminal.
+ * Under replay, the child announces every blocking read on a sync pipe, so the
+ * driver feeds the next recorded input exactly when the UI is ready for it.
+ * The time from writing a key to the next key request is the keypress-to-frame
+ * latency of show_menu().
+ *
+ * Recording format (text, one event per line):
+ *   <kind> <ms since start> <hex bytes>
+ */
+
+#include "core.h"
+#include "replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#endif
+
+#define REPLAY_FD_ENV "YDJS_REPLAY_FD"
+
+static FILE *record_fp = NULL;
+static double record_start_ms = 0;
+
+/* --- RECORDING --- */
+int input_record_start(const char *path) {
+    record_fp = fopen(path, "w");
+    if (!record_fp) return -1;
+    record_start_ms = now_ms();
+    fprintf(record_fp, "# ydjs input recording v1: <kind> <ms since start> <hex bytes>\n");
+    fflush(record_fp);
+    return 0;
+}
+
+void input_wait(char kind) {
+    fflush(stdout);
+#ifndef _WIN32
+    static int sync_fd = -2;
+    if (sync_fd == -2) {
+        const char *env = getenv(REPLAY_FD_ENV);
+        sync_fd = env ? atoi(env) : -1;
+        if (sync_fd >= 0) fcntl(sync_fd, F_SETFD, FD_CLOEXEC); /* not for git children */
+    }
+    if (sync_fd >= 0 && write(sync_fd, &kind, 1) != 1) {
+        sync_fd = -1;
+    }
+#else
+    (void)kind;
+#endif
+}
+
+void input_record(char kind, const char *bytes, size_t n) {
+    if (!record_fp) return;
+    fprintf(record_fp, "%c %.3f ", kind, now_ms() - record_start_ms);
+    for (size_t i = 0; i < n; i++) {
+        fprintf(record_fp, "%02x", (unsigned char)bytes[i]);
+    }
+    fprintf(record_fp, "\n");
+    fflush(record_fp);
+}
+
+/* --- REPLAY --- */
+#ifndef _WIN32
+typedef struct {
+    char kind;
+    char *bytes;
+    size_t len;
+} input_event;
+
+/* Loads a recording. Returns the number of events (0 on error), *out must be freed. */
+static int load_events(const char *path, input_event **out) {
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+
+    int count = 0, capacity = 64;
+    input_event *events = malloc(sizeof(input_event) * capacity);
+    char line[8192];
+    while (events && fgets(line, sizeof(line), f)) {
+        char kind;
+        double t;
+        char hex[sizeof(line)];
+        hex[0] = '\0';
+        if (line[0] == '#' || sscanf(line, "%c %lf %8191s", &kind, &t, hex) < 2) continue;
+
+        if (count >= capacity) {
+            capacity *= 2;
+            input_event *tmp = realloc(events, sizeof(input_event) * capacity);
+            if (!tmp) break;
+            events = tmp;
+        }
+        size_t len = strlen(hex) / 2;
+        input_event *ev = &events[count];
+        ev->kind = kind;
+        ev->bytes = malloc(len + 2);
+        ev->len = 0;
+        if (!ev->bytes) break;
+        for (size_t i = 0; i < len; i++) {
+            unsigned int byte;
+            if (sscanf(hex + i * 2, "%2x", &byte) != 1) break;
+            ev->bytes[ev->len++] = (char)byte;
+        }
+        /* pausef() reads in canonical mode: the terminal only delivers complete lines */
+        if (kind == INPUT_PAUSE && (ev->len == 0 || ev->bytes[ev->len - 1] != '\n')) {
+            ev->bytes[ev->len++] = '\n';
+        }
+        count++;
+    }
+    fclose(f);
+    *out = events;
+    return count;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, int n, double p) {
+    int idx = (int)(p / 100.0 * n + 0.999999) - 1;
+    if (idx < 0) idx = 0;
+    if (idx >= n) idx = n - 1;
+    return sorted[idx];
+}
+
+static int write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, buf, len);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += w;
+        len -= (size_t)w;
+    }
+    return 0;
+}
+#endif
+
+int replay_run(const char *path, int argc, char *argv[]) {
+#ifdef _WIN32
+    (void)path; (void)argc; (void)argv;
+    fprintf(stderr, "--replay needs a pseudo-terminal and is not supported on Windows.\n");
+    return 1;
+#else
+    input_event *events = NULL;
+    int event_count = load_events(path, &events);
+    if (event_count == 0) {
+        fprintf(stderr, "Error: no input events in '%s'.\n", path);
+        free(events);
+        return 1;
+    }
+
+    /* Child argv: same options minus the record/replay ones */
+    char **child_argv = malloc(sizeof(char *) * (argc + 1));
+    int child_argc = 0;
+    for (int i = 0; i < argc; i++) {
+        if (i > 0 && (strcmp(argv[i], "--replay") == 0 || strcmp(argv[i], "--record") == 0)) {
+            i++;
+            continue;
+        }
+        child_argv[child_argc++] = argv[i];
+    }
+    child_argv[child_argc] = NULL;
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    int sync_pipe[2];
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0 || pipe(sync_pipe) != 0) {
+        fprintf(stderr, "Error: could not create pseudo-terminal.\n");
+        return 1;
+    }
+    const char *slave_name = ptsname(master);
+
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(master);
+        close(sync_pipe[0]);
+        setsid();
+        int slave = open(slave_name, O_RDWR);   /* becomes the controlling terminal */
+        if (slave < 0) _exit(127);
+        #ifdef TIOCSCTTY
+        ioctl(slave, TIOCSCTTY, 0);
+        #endif
+        struct winsize ws = { 24, 80, 0, 0 };
+        ioctl(slave, TIOCSWINSZ, &ws);
+        dup2(slave, STDIN_FILENO);
+        dup2(slave, STDOUT_FILENO);
+        dup2(slave, STDERR_FILENO);
+        if (slave > STDERR_FILENO) close(slave);
+
+        char fd_str[16];
+        snprintf(fd_str, sizeof(fd_str), "%d", sync_pipe[1]);
+        setenv(REPLAY_FD_ENV, fd_str, 1);
+        #ifdef __linux__
+        execv("/proc/self/exe", child_argv);
+        #endif
+        execvp(argv[0], child_argv);
+        _exit(127);
+    }
+    close(sync_pipe[1]);
+    free(child_argv);
+    if (pid < 0) {
+        fprintf(stderr, "Error: fork failed.\n");
+        return 1;
+    }
+
+    /* Screen output is kept for inspection next to the recording */
+    char transcript_path[1024];
+    snprintf(transcript_path, sizeof(transcript_path), "%s.transcript", path);
+    FILE *transcript = fopen(transcript_path, "w");
+
+    double *latencies = malloc(sizeof(double) * event_count);
+    int latency_count = 0;
+    int next = 0, mismatches = 0;
+    char last_sent = 0;
+    double sent_at = 0, started = now_ms();
+
+    struct pollfd fds[2] = { { master, POLLIN, 0 }, { sync_pipe[0], POLLIN, 0 } };
+    int sync_open = 1;
+    while (1) {
+        if (poll(fds, sync_open ? 2 : 1, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            char buf[4096];
+            ssize_t n = read(master, buf, sizeof(buf));
+            if (n <= 0) break; /* EIO: every slave holder is gone */
+            if (transcript) fwrite(buf, 1, (size_t)n, transcript);
+        }
+
+        if (sync_open && (fds[1].revents & (POLLIN | POLLHUP | POLLERR))) {
+            char kinds[64];
+            ssize_t n = read(sync_pipe[0], kinds, sizeof(kinds));
+            if (n <= 0) {
+                sync_open = 0;
+                continue;
+            }
+            for (ssize_t i = 0; i < n; i++) {
+                /* A key followed by the next key request == one show_menu() frame */
+                if (last_sent == INPUT_KEY && kinds[i] == INPUT_KEY) {
+                    latencies[latency_count++] = now_ms() - sent_at;
+                }
+                if (next >= event_count) {
+                    fprintf(stderr, "Recording exhausted after %d events; stopping replay.\n", event_count);
+                    kill(pid, SIGTERM);
+                    last_sent = 0;
+                    continue;
+                }
+                if (events[next].kind != kinds[i]) mismatches++;
+                sent_at = now_ms();
+                last_sent = events[next].kind;
+                write_all(master, events[next].bytes, events[next].len);
+                next++;
+            }
+        }
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    double total_ms = now_ms() - started;
+    close(master);
+    close(sync_pipe[0]);
+    if (transcript) fclose(transcript);
+
+    printf("\n=== REPLAY REPORT ===\n\n");
+    printf("Recording:      %s\n", path);
+    printf("Events fed:     %d / %d\n", next, event_count);
+    if (mismatches > 0) printf("Kind mismatches: %d (recording drifted from the UI)\n", mismatches);
+    printf("Total time:     %.1f ms\n", total_ms);
+    printf("Transcript:     %s\n", transcript_path);
+    if (latency_count > 0) {
+        qsort(latencies, latency_count, sizeof(double), compare_double);
+        double sum = 0;
+        for (int i = 0; i < latency_count; i++) sum += latencies[i];
+        printf("\nshow_menu() keypress-to-frame latency (%d frames):\n", latency_count);
+        printf("  mean %.2f ms | p50 %.2f ms | p90 %.2f ms | p99 %.2f ms | max %.2f ms\n",
+               sum / latency_count,
+               percentile(latencies, latency_count, 50),
+               percentile(latencies, latency_count, 90),
+               percentile(latencies, latency_count, 99),
+               latencies[latency_count - 1]);
+    } else {
+        printf("\nNo show_menu() frames were measured.\n");
+    }
+
+    for (int i = 0; i < event_count; i++) free(events[i].bytes);
+    free(events);
+    free(latencies);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+#endif
+}
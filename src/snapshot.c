@@ -0,0 +1,153 @@
+/*
+ * Snapshot Module
+ * ---------------
+ * Author: Jaehoon, 2025
+ *
+ * A snapshot is built with plumbing only:
+ *   GIT_INDEX_FILE=<tmp> git add -A      (tmp starts as a copy of the real index, so
+ *   GIT_INDEX_FILE=<tmp> git write-tree   unchanged files are not re-hashed)
+ *   git commit-tree <tree> -p HEAD
+ *   git update-ref refs/heads/_cache_<YYYYmmdd-HHMMSS> <commit> ""
+ * GIT_INDEX_FILE is set in our own environment around the calls so the command lines
+ * stay plain 'git ...' on every platform.
+ */
+
+#include "core.h"
+#include "refs.h"
+#include "snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* --- HELPERS --- */
+static void set_index_file(const char *path) {
+#ifdef _WIN32
+    _putenv_s("GIT_INDEX_FILE", path ? path : "");
+#else
+    if (path) setenv("GIT_INDEX_FILE", path, 1);
+    else unsetenv("GIT_INDEX_FILE");
+#endif
+}
+
+static int copy_file(const char *from, const char *to) {
+    FILE *in = fopen(from, "rb");
+    if (!in) return 0;
+    FILE *out = fopen(to, "wb");
+    if (!out) {
+        fclose(in);
+        return 0;
+    }
+    char chunk[65536];
+    size_t n;
+    int ok = 1;
+    while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+        if (fwrite(chunk, 1, n, out) != n) {
+            ok = 0;
+            break;
+        }
+    }
+    fclose(in);
+    if (fclose(out) != 0) ok = 0;
+    return ok;
+}
+
+static int env_int(const char *key, int fallback) {
+    const char *value = getenv(key);
+    return (value && value[0]) ? atoi(value) : fallback;
+}
+
+/* --- SNAPSHOTS --- */
+int snapshot_save(char *name, size_t size) {
+    char git_dir[1024], index_path[1100], tmp_index[1100];
+    char head[REF_OID_MAX] = "", head_tree[REF_OID_MAX] = "", tree[REF_OID_MAX], commit[REF_OID_MAX];
+    if (!refs_git_dir(git_dir, sizeof(git_dir))) return -1;
+    snprintf(index_path, sizeof(index_path), "%s/index", git_dir);
+    snprintf(tmp_index, sizeof(tmp_index), "%s/ydjs-snapshot.index", git_dir);
+
+    int has_head = read_cmd_line(head, sizeof(head), "git rev-parse -q --verify HEAD");
+    if (has_head) read_cmd_line(head_tree, sizeof(head_tree), "git rev-parse -q --verify HEAD^{tree}");
+
+    /* 1. Stage everything into the temporary index */
+    remove(tmp_index);
+    copy_file(index_path, tmp_index); /* no index yet: add -A starts from scratch */
+    set_index_file(tmp_index);
+    int ok = run_cmd("git add -A") == 0 && read_cmd_line(tree, sizeof(tree), "git write-tree");
+    set_index_file(NULL);
+    remove(tmp_index);
+    if (!ok) return -1;
+    if (has_head && strcmp(tree, head_tree) == 0) return 0; /* nothing to save */
+
+    /* 2. Commit the tree without moving HEAD */
+    int made = has_head ? read_cmd_line(commit, sizeof(commit), "git commit-tree %s -p %s -m \"%s\"", tree, head, SNAPSHOT_PREFIX)
+                        : read_cmd_line(commit, sizeof(commit), "git commit-tree %s -m \"%s\"", tree, SNAPSHOT_PREFIX);
+    if (!made) return -1;
+
+    /* 3. Point a new snapshot branch at it ("" = must not exist yet) */
+    char stamp[32];
+    time_t now = time(NULL);
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&now));
+    int saved = 0;
+    for (int attempt = 1; attempt <= 9 && !saved; attempt++) {
+        if (attempt == 1) snprintf(name, size, "%s%s", SNAPSHOT_PREFIX, stamp);
+        else snprintf(name, size, "%s%s-%d", SNAPSHOT_PREFIX, stamp, attempt);
+        saved = run_cmd("git update-ref \"refs/heads/%s\" %s \"\" 2>%s", name, commit, NULL_DEVICE) == 0;
+    }
+    if (!saved) return -1;
+
+    snapshot_expire();
+    return 1;
+}
+
+/* Parses the timestamp of a '_cache_YYYYmmdd-HHMMSS[-n]' branch. Returns 0 for other names. */
+static int snapshot_time(const char *branch, time_t *when) {
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    if (strncmp(branch, SNAPSHOT_PREFIX, strlen(SNAPSHOT_PREFIX)) != 0) return 0;
+    if (sscanf(branch + strlen(SNAPSHOT_PREFIX), "%4d%2d%2d-%2d%2d%2d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+               &tm.tm_hour, &tm.tm_min, &tm.tm_sec) != 6) {
+        return 0;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    tm.tm_isdst = -1;
+    *when = mktime(&tm);
+    return 1;
+}
+
+int snapshot_expire(void) {
+    ref_list snapshots;
+    if (refs_list("refs/heads/" SNAPSHOT_PREFIX, &snapshots) < 0) return 0;
+
+    int keep = env_int("CACHE_SNAPSHOTS", 5);
+    int max_days = env_int("CACHE_EXPIRE_DAYS", 14);
+    char current[REF_NAME_MAX] = "";
+    refs_head_branch(current, sizeof(current));
+
+    char *expired = calloc(snapshots.count > 0 ? snapshots.count : 1, 1);
+    if (!expired) {
+        refs_free(&snapshots);
+        return 0;
+    }
+
+    /* Sorted by name = oldest first, so the ring overflow is at the front */
+    int total = 0;
+    time_t when, now = time(NULL);
+    for (int i = 0; i < snapshots.count; i++) {
+        if (snapshot_time(snapshots.items[i].name + strlen("refs/heads/"), &when)) total++;
+    }
+    int seen = 0;
+    for (int i = 0; i < snapshots.count; i++) {
+        const char *branch = snapshots.items[i].name + strlen("refs/heads/");
+        if (!snapshot_time(branch, &when)) continue; /* e.g. the legacy '_cache_' branch */
+        seen++;
+        if (strcmp(branch, current) == 0) continue;
+        if (seen <= total - keep) expired[i] = 1;
+        if (max_days > 0 && difftime(now, when) > max_days * 86400.0) expired[i] = 1;
+    }
+
+    int count = refs_delete_flagged(&snapshots, expired);
+    free(expired);
+    refs_free(&snapshots);
+    return count > 0 ? count : 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Resource Accounting Module
+ * --------------------------
+ * Author: Jaehoon, 2025
+ *
+ * Aggregates the cost (wall, CPU, peak RSS, block I/O) of every child process
+ * per flow and per command, and prints a summary table on request.
+ */
+
+#include "stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#define STATS_MAX_ROWS 64
+
+typedef struct {
+    char flow[16];
+    char command[32];
+    int calls;
+    proc_usage total;   /* max_rss_kb holds the peak, everything else is summed */
+} stats_row;
+
+static stats_row rows[STATS_MAX_ROWS];
+static int row_count = 0;
+static int enabled = 0;
+static char current_flow[16] = "startup";
+
+void stats_enable(void) {
+    enabled = 1;
+}
+
+int stats_enabled(void) {
+    return enabled;
+}
+
+void stats_set_flow(const char *flow) {
+    snprintf(current_flow, sizeof(current_flow), "%s", flow ? flow : "other");
+}
+
+/* Copies the next whitespace-separated word of 'p' into 'word' (quotes stripped).
+ * Returns the position right after it. */
+static const char *next_word(const char *p, char *word, size_t size) {
+    size_t n = 0;
+    while (*p && isspace((unsigned char)*p)) p++;
+    while (*p && !isspace((unsigned char)*p)) {
+        if (*p != '"' && *p != '\'' && n + 1 < size) word[n++] = *p;
+        p++;
+    }
+    word[n] = '\0';
+    return p;
+}
+
+/* Reduces a command line to its key: "git add . && ..." -> "git add",
+ * "git -C repo fetch" -> "git fetch". */
+static void command_key(const char *command, char *key, size_t size) {
+    char prog[32], sub[32], skip[256];
+    const char *p = next_word(command, prog, sizeof(prog));
+    p = next_word(p, sub, sizeof(sub));
+    if (strcmp(sub, "-C") == 0) {
+        p = next_word(p, skip, sizeof(skip));
+        next_word(p, sub, sizeof(sub));
+    }
+    if (sub[0] == '\0' || sub[0] == '-' || sub[0] == '>' || sub[0] == '|' || sub[0] == '&') {
+        snprintf(key, size, "%s", prog);
+    } else {
+        /* Keys are short by design: give each word at most half of 'size' */
+        int half = (int)(size / 2) - 1;
+        snprintf(key, size, "%.*s %.*s", half, prog, half, sub);
+    }
+}
+
+void stats_record(const char *command, const proc_usage *usage) {
+    char key[32];
+    command_key(command, key, sizeof(key));
+
+    stats_row *row = NULL;
+    for (int i = 0; i < row_count; i++) {
+        if (strcmp(rows[i].flow, current_flow) == 0 && strcmp(rows[i].command, key) == 0) {
+            row = &rows[i];
+            break;
+        }
+    }
+    if (!row) {
+        if (row_count >= STATS_MAX_ROWS) return; /* table full: drop silently */
+        row = &rows[row_count++];
+        memset(row, 0, sizeof(*row));
+        snprintf(row->flow, sizeof(row->flow), "%s", current_flow);
+        snprintf(row->command, sizeof(row->command), "%s", key);
+    }
+
+    row->calls++;
+    row->total.wall_ms += usage->wall_ms;
+    row->total.user_ms += usage->user_ms;
+    row->total.sys_ms += usage->sys_ms;
+    row->total.in_blocks += usage->in_blocks;
+    row->total.out_blocks += usage->out_blocks;
+    if (usage->max_rss_kb > row->total.max_rss_kb) row->total.max_rss_kb = usage->max_rss_kb;
+}
+
+static void print_row(const char *flow, const char *command, int calls, const proc_usage *u) {
+    printf("%-10s %-18s %6d %10.1f %10.1f %10.1f %10ld %8ld %8ld\n",
+           flow, command, calls, u->wall_ms, u->user_ms, u->sys_ms,
+           u->max_rss_kb, u->in_blocks, u->out_blocks);
+}
+
+void stats_print_summary(void) {
+    printf("\n=== CHILD PROCESS STATISTICS ===\n\n");
+    if (row_count == 0) {
+        printf("No child processes were run.\n");
+        return;
+    }
+    printf("%-10s %-18s %6s %10s %10s %10s %10s %8s %8s\n",
+           "Flow", "Command", "Calls", "Wall(ms)", "User(ms)", "Sys(ms)",
+           "MaxRSS(KB)", "BlkIn", "BlkOut");
+
+    /* Rows are grouped by flow in first-seen order, each flow followed by its total. */
+    int done[STATS_MAX_ROWS] = {0};
+    for (int i = 0; i < row_count; i++) {
+        if (done[i]) continue;
+        proc_usage sum;
+        memset(&sum, 0, sizeof(sum));
+        int calls = 0;
+        for (int j = i; j < row_count; j++) {
+            if (done[j] || strcmp(rows[j].flow, rows[i].flow) != 0) continue;
+            done[j] = 1;
+            print_row(rows[j].flow, rows[j].command, rows[j].calls, &rows[j].total);
+            calls += rows[j].calls;
+            sum.wall_ms += rows[j].total.wall_ms;
+            sum.user_ms += rows[j].total.user_ms;
+            sum.sys_ms += rows[j].total.sys_ms;
+            sum.in_blocks += rows[j].total.in_blocks;
+            sum.out_blocks += rows[j].total.out_blocks;
+            if (rows[j].total.max_rss_kb > sum.max_rss_kb) sum.max_rss_kb = rows[j].total.max_rss_kb;
+        }
+        print_row(rows[i].flow, "(total)", calls, &sum);
+        printf("\n");
+    }
+}
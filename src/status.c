@@ -0,0 +1,164 @@
+/*
+ * Status Panel Module
+ * -------------------
+ * Author: Jaehoon, 2025
+ *
+ * Porcelain v2 records, NUL-terminated with -z:
+ *   # branch.head <name>|(detached)
+ *   # branch.upstream <name>
+ *   # branch.ab +<ahead> -<behind>
+ *   1 <XY> <sub> <mH> <mI> <mW> <hH> <hI> <path>                 ordinary change
+ *   2 <XY> <sub> <mH> <mI> <mW> <hH> <hI> <Xscore> <path>\0<orig>  rename/copy (two records)
+ *   u <XY> <sub> <m1> <m2> <m3> <mW> <h1> <h2> <h3> <path>        unmerged
+ *   ? <path>                                                       untracked
+ * X is the index side (staged), Y the work tree side; '.' means unchanged.
+ */
+
+#include "core.h"
+#include "status.h"
+#include "refs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/* --- CHANGE DETECTION --- */
+static void append_stamp(char *stamp, size_t size, const char *path) {
+    struct stat st;
+    size_t len = strlen(stamp);
+    if (len >= size - 1) return;
+    if (stat(path, &st) != 0) snprintf(stamp + len, size - len, "-;");
+    else snprintf(stamp + len, size - len, "%lu:%ld:%ld;", (unsigned long)st.st_ino, (long)st.st_size, (long)st.st_mtime);
+}
+
+/* git replaces these files through lock files, so a change gets a new inode even when the
+ * mtime second is the same */
+static int repo_stamp(char *stamp, size_t size) {
+    char git_dir[1024], common[1024], path[1400], branch[REF_NAME_MAX];
+    if (!refs_git_dir(git_dir, sizeof(git_dir)) || !refs_common_dir(common, sizeof(common))) return -1;
+    stamp[0] = '\0';
+    snprintf(path, sizeof(path), "%s/index", git_dir);
+    append_stamp(stamp, size, path);
+    snprintf(path, sizeof(path), "%s/HEAD", git_dir);
+    append_stamp(stamp, size, path);
+    if (refs_head_branch(branch, sizeof(branch))) {
+        snprintf(path, sizeof(path), "%s/refs/heads/%s", common, branch);
+        append_stamp(stamp, size, path);
+    }
+    snprintf(path, sizeof(path), "%s/packed-refs", common);
+    append_stamp(stamp, size, path);
+    return 0;
+}
+
+/* --- PARSING --- */
+/* Skips 'fields' space-separated fields; returns the rest (the path) */
+static const char *skip_fields(const char *record, int fields) {
+    for (int i = 0; i < fields && record; i++) {
+        record = strchr(record, ' ');
+        if (record) record++;
+    }
+    return record ? record : "";
+}
+
+static void add_path(status_panel *panel, char x, char y, const char *path) {
+    panel->entries++;
+    if (panel->path_count == STATUS_PANEL_PATHS) return;
+    /* Long paths are cut for display; the panel only shows the start of each */
+    snprintf(panel->paths[panel->path_count++], sizeof(panel->paths[0]), "%c%c %.*s", x, y,
+             (int)sizeof(panel->paths[0]) - 4, path);
+}
+
+static void parse_record(status_panel *panel, const char *record) {
+    if (strncmp(record, "# branch.head ", 14) == 0) {
+        snprintf(panel->branch, sizeof(panel->branch), "%.*s", (int)sizeof(panel->branch) - 1, record + 14);
+    } else if (strncmp(record, "# branch.upstream ", 18) == 0) {
+        snprintf(panel->upstream, sizeof(panel->upstream), "%.*s", (int)sizeof(panel->upstream) - 1, record + 18);
+    } else if (strncmp(record, "# branch.ab ", 12) == 0) {
+        sscanf(record + 12, "+%d -%d", &panel->ahead, &panel->behind);
+    } else if ((record[0] == '1' || record[0] == '2') && record[1] == ' ' && record[2] && record[3]) {
+        char x = record[2], y = record[3];
+        if (x != '.') panel->staged++;
+        if (y != '.') panel->modified++;
+        add_path(panel, x == '.' ? ' ' : x, y == '.' ? ' ' : y, skip_fields(record, record[0] == '1' ? 8 : 9));
+    } else if (record[0] == 'u' && record[1] == ' ') {
+        panel->conflicted++;
+        add_path(panel, 'U', 'U', skip_fields(record, 10));
+    } else if (record[0] == '?' && record[1] == ' ') {
+        panel->untracked++;
+        add_path(panel, '?', '?', record + 2);
+    }
+}
+
+static int scan(status_panel *panel) {
+    double start = now_ms();
+    FILE *fp = open_cmd("rb", "git status --porcelain=v2 -z --branch 2>%s", NULL_DEVICE);
+    if (!fp) return -1;
+
+    status_panel fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    char record[4096];
+    size_t len = 0;
+    int skip_next = 0, c;
+    while ((c = getc(fp)) != EOF) {
+        if (c != '\0') {
+            if (len < sizeof(record) - 1) record[len++] = (char)c;
+            continue;
+        }
+        record[len] = '\0';
+        len = 0;
+        if (skip_next) {
+            skip_next = 0; /* original path of a rename */
+            continue;
+        }
+        parse_record(&fresh, record);
+        skip_next = record[0] == '2';
+    }
+    if (close_cmd(fp) != 0) return -1;
+
+    fresh.scan_ms = now_ms() - start;
+    *panel = fresh;
+    return 0;
+}
+
+/* --- PUBLIC API --- */
+int status_panel_refresh(status_panel *panel) {
+    char before[sizeof(panel->stamp)];
+    if (repo_stamp(before, sizeof(before)) != 0) {
+        panel->stamp[0] = '\0';
+        return -1;
+    }
+    if (panel->stamp[0] && strcmp(before, panel->stamp) == 0) return 0;
+    if (scan(panel) != 0) {
+        panel->stamp[0] = '\0';
+        return -1;
+    }
+    /* Taken after the scan: git status may refresh the index itself */
+    repo_stamp(panel->stamp, sizeof(panel->stamp));
+    return 1;
+}
+
+int status_panel_print(const status_panel *panel) {
+    if (!panel->stamp[0]) {
+        printf("Current branch: (status unavailable)\n\n");
+        return 2;
+    }
+    printf("Current branch: %s", panel->branch);
+    if (panel->upstream[0]) {
+        printf(" -> %s", panel->upstream);
+        if (panel->ahead || panel->behind) printf(" [ahead %d, behind %d]", panel->ahead, panel->behind);
+    }
+    printf("\n");
+
+    if (panel->entries == 0) {
+        printf("Working tree clean (%.0f ms)\n\n", panel->scan_ms);
+        return 3;
+    }
+    printf("%d staged, %d modified, %d untracked", panel->staged, panel->modified, panel->untracked);
+    if (panel->conflicted) printf(", %d conflicted", panel->conflicted);
+    printf(" (%.0f ms)\n", panel->scan_ms);
+    for (int i = 0; i < panel->path_count; i++) printf("   %.70s\n", panel->paths[i]);
+    int more = panel->entries > panel->path_count;
+    if (more) printf("   ... %d more\n", panel->entries - panel->path_count);
+    printf("\n");
+    return 3 + panel->path_count + more;
+}
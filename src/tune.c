@@ -0,0 +1,204 @@
+/*
+ * Tune Module
+ * -----------
+ * Author: Jaehoon, 2025
+ *
+ * Profile, per repository:
+ *   checkout.workers   cores on local disks, 2x cores (max 32) on network filesystems
+ *                      where each file write is a round trip; 1 below 4 cores
+ *   index.threads      cores (index loading is CPU bound)
+ *   pack.threads       cores
+ *   fetch.parallel     cores, max 8 (remotes/submodules fetched at once)
+ *   feature.manyFiles  true from 100k tracked files (index v4 + untracked cache)
+ * The tracked-file count comes from the index header, so tuning never walks the tree.
+ */
+
+#include "core.h"
+#include "tune.h"
+#include "workspace.h"
+#include "stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <sys/vfs.h>
+#elif defined(__APPLE__)
+#include <sys/param.h>
+#include <sys/mount.h>
+#endif
+
+#define MANY_FILES 100000
+
+typedef struct {
+    int cores;
+    char fs[32];            /* filesystem name, "unknown" if not detected */
+    int network;            /* 1 for NFS/SMB/9p/FUSE and other remote mounts */
+    long files;             /* index entries, -1 if there is no index yet */
+} tune_env;
+
+/* --- HELPERS --- */
+static void detect_fs(const char *path, tune_env *env) {
+    snprintf(env->fs, sizeof(env->fs), "unknown");
+    env->network = 0;
+#ifdef __linux__
+    struct statfs st;
+    if (statfs(path, &st) != 0) return;
+    static const struct { unsigned long magic; const char *name; int network; } types[] = {
+        { 0xEF53, "ext4", 0 },          { 0x9123683E, "btrfs", 0 },   { 0x58465342, "xfs", 0 },
+        { 0x01021994, "tmpfs", 0 },     { 0x794C7630, "overlay", 0 }, { 0x2FC12FC1, "zfs", 0 },
+        { 0x6969, "nfs", 1 },           { 0x517B, "smb", 1 },         { 0xFF534D42, "cifs", 1 },
+        { 0xFE534D42, "smb2", 1 },      { 0x01021997, "9p", 1 },      { 0x65735546, "fuse", 1 },
+    };
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        if ((unsigned long)st.f_type == types[i].magic) {
+            snprintf(env->fs, sizeof(env->fs), "%s", types[i].name);
+            env->network = types[i].network;
+            return;
+        }
+    }
+    snprintf(env->fs, sizeof(env->fs), "0x%lx", (unsigned long)st.f_type);
+#elif defined(__APPLE__)
+    struct statfs st;
+    if (statfs(path, &st) != 0) return;
+    snprintf(env->fs, sizeof(env->fs), "%s", st.f_fstypename);
+    env->network = !(st.f_flags & MNT_LOCAL);
+#elif defined(_WIN32)
+    char full[MAX_PATH], root[MAX_PATH], name[32];
+    if (!GetFullPathNameA(path, sizeof(full), full, NULL) || !GetVolumePathNameA(full, root, sizeof(root))) return;
+    if (GetVolumeInformationA(root, NULL, 0, NULL, NULL, NULL, name, sizeof(name))) {
+        snprintf(env->fs, sizeof(env->fs), "%s", name);
+    }
+    env->network = GetDriveTypeA(root) == DRIVE_REMOTE;
+#else
+    (void)path;
+#endif
+}
+
+/* Entry count from the index header: "DIRC", version, entries (all big-endian 32-bit) */
+static long index_entries(const char *git_dir) {
+    char path[1100];
+    unsigned char header[12];
+    snprintf(path, sizeof(path), "%s/index", git_dir);
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+    size_t n = fread(header, 1, sizeof(header), f);
+    fclose(f);
+    if (n != sizeof(header) || memcmp(header, "DIRC", 4) != 0) return -1;
+    return ((long)header[8] << 24) | ((long)header[9] << 16) | ((long)header[10] << 8) | (long)header[11];
+}
+
+/* --- MEASUREMENT --- */
+/* Best of two runs, so the first one can warm the caches */
+static double time_status(const char *dir) {
+    double best = -1;
+    for (int run = 0; run < 2; run++) {
+        double start = now_ms();
+        if (run_cmd("git -C \"%s\" status --porcelain >%s 2>&1", dir, NULL_DEVICE) != 0) return -1;
+        double elapsed = now_ms() - start;
+        if (best < 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+/* Full checkout of the index into a scratch directory: exercises checkout.workers
+ * without touching the user's files */
+static double time_checkout(const char *dir, const char *git_dir) {
+    char scratch[1200];
+    snprintf(scratch, sizeof(scratch), "%s/ydjs-tune-checkout", git_dir);
+#ifdef _WIN32
+    run_cmd("if exist \"%s\" rmdir /s /q \"%s\"", scratch, scratch);
+#else
+    run_cmd("rm -rf \"%s\"", scratch);
+#endif
+    double start = now_ms();
+    int rc = run_cmd("git -C \"%s\" checkout-index -a -f --prefix=\"%s/\" >%s 2>&1", dir, scratch, NULL_DEVICE);
+    double elapsed = now_ms() - start;
+#ifdef _WIN32
+    run_cmd("if exist \"%s\" rmdir /s /q \"%s\"", scratch, scratch);
+#else
+    run_cmd("rm -rf \"%s\"", scratch);
+#endif
+    return rc == 0 ? elapsed : -1;
+}
+
+static void print_timing(const char *label, double before, double after) {
+    if (before < 0 || after < 0) {
+        printf("  %-18s %10s\n", label, "n/a");
+        return;
+    }
+    double change = before > 0 ? (after - before) * 100.0 / before : 0;
+    printf("  %-18s %8.1f ms -> %8.1f ms  (%+.0f%%)\n", label, before, after, change);
+}
+
+/* --- TUNING --- */
+int tune_repo(const char *dir, int measure) {
+    char git_dir[1024];
+    if (!read_cmd_line(git_dir, sizeof(git_dir), "git -C \"%s\" rev-parse --absolute-git-dir", dir)) return -1;
+
+    tune_env env;
+    env.cores = cpu_count();
+    env.files = index_entries(git_dir);
+    detect_fs(dir, &env);
+
+    int checkout_workers = env.cores < 4 ? 1 : env.cores;
+    if (env.network) checkout_workers = env.cores * 2 > 32 ? 32 : env.cores * 2;
+    int fetch_parallel = env.cores > 8 ? 8 : env.cores;
+
+    char values[5][32];
+    const char *keys[5] = { "checkout.workers", "index.threads", "pack.threads", "fetch.parallel", "feature.manyFiles" };
+    snprintf(values[0], sizeof(values[0]), "%d", checkout_workers);
+    snprintf(values[1], sizeof(values[1]), "%d", env.cores);
+    snprintf(values[2], sizeof(values[2]), "%d", env.cores);
+    snprintf(values[3], sizeof(values[3]), "%d", fetch_parallel);
+    snprintf(values[4], sizeof(values[4]), "%s", env.files >= MANY_FILES ? "true" : "");
+
+    double status_before = -1, checkout_before = -1;
+    if (measure) {
+        printf("\n%s: %ld tracked files, %s%s, %d core(s)\n", dir, env.files, env.fs,
+               env.network ? " (network)" : "", env.cores);
+        status_before = time_status(dir);
+        checkout_before = time_checkout(dir, git_dir);
+    }
+
+    for (int i = 0; i < 5; i++) {
+        char old[64] = "";
+        read_cmd_line(old, sizeof(old), "git -C \"%s\" config --local --get %s", dir, keys[i]);
+        if (!values[i][0]) { /* small repos keep git's defaults */
+            if (measure) printf("  %-18s %8s -> unchanged (under %d files)\n", keys[i], old[0] ? old : "(unset)", MANY_FILES);
+            continue;
+        }
+        if (strcmp(old, values[i]) != 0) {
+            run_cmd("git -C \"%s\" config --local %s %s", dir, keys[i], values[i]);
+        }
+        if (measure) printf("  %-18s %8s -> %s\n", keys[i], old[0] ? old : "(unset)", values[i]);
+    }
+
+    if (measure) {
+        print_timing("status", status_before, time_status(dir));
+        print_timing("checkout (full)", checkout_before, time_checkout(dir, git_dir));
+    }
+    return 0;
+}
+
+void tune_action(void) {
+    stats_set_flow("tune");
+    clear_screen();
+    printf("--- TUNE GIT PERFORMANCE ---\n");
+    printf("Sets repo-local parallelism for this machine and compares timings.\n");
+
+    ws_repo *repos = NULL;
+    int repo_count = workspace_load(&repos);
+    int tuned = 0;
+    for (int i = 0; i < repo_count; i++) {
+        if (!repos[i].exists) continue;
+        if (tune_repo(repos[i].path, 1) == 0) tuned++;
+        else printf("\n%s: not a git repository, skipped.\n", repos[i].path);
+    }
+    free(repos);
+    if (tuned == 0 && tune_repo(".", 1) != 0) printf("\nNo repository to tune.\n");
+
+    printf("\n");
+    lazyprintf("Next: Returning to main menu");
+    pausef(NULL);
+}
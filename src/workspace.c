@@ -0,0 +1,593 @@
+/*
+ * Workspace Module
+ * ----------------
+ * Author: Jaehoon, 2025
+ *
+ * Fetch / commit / status across every managed repository concurrently.
+ */
+
+#include "workspace.h"
+#include "manifest.h"
+#include "pool.h"
+#include "stats.h"
+#include "core.h"
+#include "remote.h"
+#include "progress.h"
+#include "refs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* --- REPO LIST --- */
+int workspace_load(ws_repo **out) {
+    *out = NULL;
+    manifest m;
+    char error[512];
+    if (manifest_load(&m, error, sizeof(error)) != 0) {
+        if (ACCESS(MANIFEST_FILE) == 0) printf("Error: %s.\n", error); /* else nothing is defined */
+        return 0;
+    }
+
+    const char *base = getenv("WORKSPACE_DIR");
+    const char *groups = getenv("WORKSPACE_GROUPS");
+    ws_repo *repos = calloc(m.count > 0 ? m.count : 1, sizeof(ws_repo));
+    if (!repos) {
+        manifest_free(&m);
+        return 0;
+    }
+
+    int count = 0;
+    for (int i = 0; i < m.count; i++) {
+        const manifest_entry *entry = &m.entries[i];
+        if (!manifest_in_groups(entry, groups)) continue;
+        ws_repo *repo = &repos[count++];
+        snprintf(repo->name, sizeof(repo->name), "%s", entry->path);
+        if (base && base[0]) {
+            snprintf(repo->path, sizeof(repo->path), "%s/%s", base, entry->path);
+        } else {
+            snprintf(repo->path, sizeof(repo->path), "%s", entry->path);
+            if (ACCESS(repo->path) != 0) {
+                /* Running from inside one of the repos: look for its siblings */
+                char sibling[1024];
+                snprintf(sibling, sizeof(sibling), "../%s", entry->path);
+                if (ACCESS(sibling) == 0) snprintf(repo->path, sizeof(repo->path), "%s", sibling);
+            }
+        }
+        repo->exists = (ACCESS(repo->path) == 0);
+    }
+
+    manifest_free(&m);
+    *out = repos;
+    return count;
+}
+
+void workspace_root(char *root, size_t size) {
+    const char *base = getenv("WORKSPACE_DIR");
+    if (base && base[0]) snprintf(root, size, "%s", base);
+    else snprintf(root, size, "%s", ACCESS(".git") == 0 ? ".." : "."); /* inside one of the repos */
+}
+
+/* Builds one pool job per existing repo. Returns the job count, or -1 if out of memory;
+ * *jobs must be freed. */
+static int build_jobs(const ws_repo *repos, int repo_count, const char *command, pool_job **jobs) {
+    *jobs = calloc(repo_count > 0 ? repo_count : 1, sizeof(pool_job));
+    if (!*jobs) return -1;
+    int n = 0;
+    for (int i = 0; i < repo_count; i++) {
+        if (!repos[i].exists) continue;
+        pool_job *job = &(*jobs)[n++];
+        snprintf(job->label, sizeof(job->label), "%s", repos[i].name);
+        snprintf(job->cwd, sizeof(job->cwd), "%s", repos[i].path);
+        snprintf(job->command, sizeof(job->command), "%s", command);
+    }
+    return n;
+}
+
+/* --- OUTPUT PARSING --- */
+/* Copies the last non-empty line of 'text' into 'line'. */
+static void last_line(const char *text, char *line, size_t size) {
+    line[0] = '\0';
+    if (!text) return;
+    const char *end = text + strlen(text);
+    while (end > text && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ')) end--;
+    const char *start = end;
+    while (start > text && start[-1] != '\n' && start[-1] != '\r') start--;
+    size_t len = (size_t)(end - start);
+    if (len >= size) len = size - 1;
+    memcpy(line, start, len);
+    line[len] = '\0';
+}
+
+static int count_lines_containing(const char *text, const char *needle) {
+    int count = 0;
+    if (!text) return 0;
+    for (const char *p = text; (p = strstr(p, needle)) != NULL; p += strlen(needle)) count++;
+    return count;
+}
+
+typedef void (*detail_fn)(const pool_job *job, char *detail, size_t size);
+
+static void fetch_detail(const pool_job *job, char *detail, size_t size) {
+    if (job->exit_code != 0) {
+        last_line(job->output, detail, size);
+        return;
+    }
+    int updated = count_lines_containing(job->output, "->");
+    if (updated == 0) snprintf(detail, size, "up to date");
+    else snprintf(detail, size, "%d ref(s) updated", updated);
+}
+
+static void commit_detail(const pool_job *job, char *detail, size_t size) {
+    if (job->exit_code != 0) {
+        last_line(job->output, detail, size);
+    } else if (job->output && strstr(job->output, "nothing to commit")) {
+        snprintf(detail, size, "clean, nothing to commit");
+    } else {
+        snprintf(detail, size, "committed and pushed");
+    }
+}
+
+typedef struct {
+    char branch[128];
+    int upstream;       /* 1 if the branch tracks one ("main...origin/main") */
+    int ahead, behind;
+    int changes;
+} status_info;
+
+/* 'git status --porcelain --branch': "## main...origin/main [ahead 1, behind 2]" + one line per change */
+static void parse_status(const char *output, status_info *info) {
+    memset(info, 0, sizeof(*info));
+    snprintf(info->branch, sizeof(info->branch), "?");
+    const char *line = output ? output : "";
+    while (*line) {
+        const char *eol = strchr(line, '\n');
+        size_t len = eol ? (size_t)(eol - line) : strlen(line);
+        if (len >= 3 && strncmp(line, "## ", 3) == 0) {
+            /* "## <branch>[...<upstream> [...]]", "## No commits yet on <branch>" (older git:
+             * "## Initial commit on <branch>") or "## HEAD (no branch)". Branch names may
+             * contain '.', so the name ends at the "..." separator or a space. */
+            const char *name = line + 3;
+            if (strncmp(name, "No commits yet on ", 18) == 0) name += 18;
+            else if (strncmp(name, "Initial commit on ", 18) == 0) name += 18;
+            const char *u = strstr(line, "...");
+            size_t blen = strcspn(name, " \n");
+            if (u && (!eol || u < eol) && (size_t)(u - name) < blen) blen = (size_t)(u - name);
+            if (strncmp(name, "HEAD (no branch)", 16) == 0) {
+                snprintf(info->branch, sizeof(info->branch), "(detached)");
+            } else {
+                if (blen >= sizeof(info->branch)) blen = sizeof(info->branch) - 1;
+                memcpy(info->branch, name, blen);
+                info->branch[blen] = '\0';
+            }
+            const char *a = strstr(line, "ahead ");
+            const char *b = strstr(line, "behind ");
+            if (u && (!eol || u < eol)) info->upstream = 1;
+            if (a && (!eol || a < eol)) info->ahead = atoi(a + 6);
+            if (b && (!eol || b < eol)) info->behind = atoi(b + 7);
+        } else if (len > 0) {
+            info->changes++;
+        }
+        if (!eol) break;
+        line = eol + 1;
+    }
+}
+
+static void status_detail(const pool_job *job, char *detail, size_t size) {
+    if (job->exit_code != 0 || !job->output) {
+        last_line(job->output, detail, size);
+        return;
+    }
+    status_info info;
+    parse_status(job->output, &info);
+    snprintf(detail, size, "%-20s %4d changed  +%d/-%d", info.branch, info.changes, info.ahead, info.behind);
+}
+
+static void print_summary(const char *title, const ws_repo *repos, int repo_count,
+                          const pool_job *jobs, int job_count, detail_fn detail) {
+    printf("\n=== %s ===\n\n", title);
+    printf("%-28s %-6s %9s  %s\n", "Repo", "Result", "Time(ms)", "Detail");
+    for (int i = 0; i < job_count; i++) {
+        char text[256];
+        detail(&jobs[i], text, sizeof(text));
+        printf("%-28s %-6s %9.0f  %s\n", jobs[i].label,
+               jobs[i].exit_code == 0 ? "ok" : "FAIL", jobs[i].wall_ms, text);
+    }
+    for (int i = 0; i < repo_count; i++) {
+        if (!repos[i].exists) printf("%-28s %-6s %9s  %s\n", repos[i].name, "skip", "-", "not cloned");
+    }
+}
+
+/* Loads the repo list and runs 'command' in every repo. Returns 0 if nothing could be run. */
+static int run_everywhere(const char *title, const char *command, detail_fn detail) {
+    ws_repo *repos = NULL;
+    int repo_count = workspace_load(&repos);
+    if (repo_count == 0) {
+        printf("No repositories defined (%s or REPO_NAMES in .env).\n", MANIFEST_FILE);
+        free(repos);
+        return 0;
+    }
+
+    pool_job *jobs = NULL;
+    int job_count = build_jobs(repos, repo_count, command, &jobs);
+    if (job_count < 0) {
+        printf("Error: out of memory.\n");
+        free(repos);
+        return 0;
+    }
+    int workers = pool_default_workers();
+    printf("Running in %d repositories with %d workers...\n", job_count, workers);
+
+    double start = now_ms();
+    int failed = pool_run(jobs, job_count, workers);
+    print_summary(title, repos, repo_count, jobs, job_count, detail);
+    printf("\n%d ok, %d failed, %.1f s total\n", job_count - failed, failed, (now_ms() - start) / 1000.0);
+
+    pool_free(jobs, job_count);
+    free(jobs);
+    free(repos);
+    return 1;
+}
+
+/* The refs/remote helpers work on the current directory: step into a repo and back */
+static char start_dir[1024];
+
+static int enter_repo(const char *path) {
+    if (!GET_CWD(start_dir, sizeof(start_dir))) return 0;
+    return CHANGE_DIR(path) == 0;
+}
+
+static void leave_repo(void) {
+    if (CHANGE_DIR(start_dir) != 0) printf("Warning: could not return to %s\n", start_dir);
+}
+
+/* --- ACTIONS --- */
+/* Fetch All with the freshness policy: repos fetched less than FETCH_FRESHNESS seconds ago get
+ * a parallel 'ls-remote --heads' round first, and only those whose tips moved are fetched. */
+void workspace_fetch_all(void) {
+    stats_set_flow("fetch-all");
+    clear_screen();
+    printf("--- FETCH ALL REPOSITORIES ---\n");
+
+    ws_repo *repos = NULL;
+    int repo_count = workspace_load(&repos);
+    if (repo_count == 0) {
+        printf("No repositories defined (%s or REPO_NAMES in .env).\n", MANIFEST_FILE);
+        free(repos);
+        lazyprintf("Next: Returning to main menu");
+        pausef(NULL);
+        return;
+    }
+
+    /* 1. Split into recently fetched repos (tip check) and the rest (full fetch) */
+    int window = remote_freshness_window();
+    ws_repo *recent = calloc(repo_count, sizeof(ws_repo));
+    ws_repo *stale = calloc(repo_count, sizeof(ws_repo));
+    double *ages = calloc(repo_count, sizeof(double));
+    char *fresh = calloc(repo_count, 1);
+    if (!recent || !stale || !ages || !fresh) {
+        free(recent);
+        free(stale);
+        free(ages);
+        free(fresh);
+        free(repos);
+        return;
+    }
+    for (int i = 0; i < repo_count; i++) {
+        recent[i] = stale[i] = repos[i];
+        ages[i] = -1;
+        if (repos[i].exists && window > 0 && enter_repo(repos[i].path)) {
+            ages[i] = remote_fetch_age("origin");
+            leave_repo();
+        }
+        int is_recent = ages[i] >= 0 && ages[i] < window;
+        if (is_recent) stale[i].exists = 0;
+        else recent[i].exists = 0;
+    }
+
+    int workers = pool_default_workers();
+    double start = now_ms();
+
+    /* 2. Tip comparison for the recent ones; unchanged repos need no fetch at all */
+    pool_job *checks = NULL;
+    int check_count = build_jobs(recent, repo_count, "git ls-remote --heads origin", &checks);
+    if (check_count < 0) {
+        printf("Error: out of memory.\n");
+        free(fresh);
+        free(ages);
+        free(recent);
+        free(stale);
+        free(repos);
+        lazyprintf("Next: Returning to main menu");
+        pausef(NULL);
+        return;
+    }
+    if (check_count > 0) {
+        printf("Checking %d recently fetched repositories with ls-remote...\n", check_count);
+        pool_run(checks, check_count, workers);
+    }
+    for (int i = 0, c = 0; i < repo_count; i++) {
+        if (!recent[i].exists) continue;
+        pool_job *check = &checks[c++];
+        if (check->exit_code == 0 && enter_repo(recent[i].path)) {
+            fresh[i] = remote_tips_match("origin", check->output);
+            leave_repo();
+        }
+        if (!fresh[i]) stale[i].exists = 1;
+    }
+
+    /* 3. Full fetch of everything else, under the live progress view */
+    pool_job *jobs = NULL;
+    int job_count = build_jobs(stale, repo_count, "git fetch --all --prune --progress", &jobs);
+    if (job_count < 0) {
+        printf("Error: out of memory.\n");
+        pool_free(checks, check_count);
+        free(checks);
+        free(fresh);
+        free(ages);
+        free(recent);
+        free(stale);
+        free(repos);
+        lazyprintf("Next: Returning to main menu");
+        pausef(NULL);
+        return;
+    }
+    for (int j = 0; j < job_count; j++) {
+        progress_log_path(jobs[j].label, "fetch", jobs[j].log_path, sizeof(jobs[j].log_path));
+    }
+    int failed = 0;
+    progress_view view;
+    if (job_count > 0) printf("Fetching %d repositories with %d workers...\n", job_count, workers);
+    if (job_count > 0 && progress_init(&view, "Fetching", job_count) == 0) {
+        failed = pool_run_observed(jobs, job_count, workers, progress_observe, &view);
+        progress_finish(&view, jobs, job_count);
+        progress_free(&view);
+    } else {
+        failed = pool_run(jobs, job_count, workers);
+    }
+    for (int i = 0, j = 0; i < repo_count; i++) {
+        if (!stale[i].exists) continue;
+        if (jobs[j++].exit_code == 0 && enter_repo(stale[i].path)) {
+            remote_mark_fetched("origin");
+            leave_repo();
+        }
+    }
+
+    print_summary("FETCH SUMMARY", repos, repo_count, jobs, job_count, fetch_detail);
+    int fresh_count = 0;
+    for (int i = 0; i < repo_count; i++) {
+        if (!fresh[i]) continue;
+        fresh_count++;
+        printf("%-28s %-6s %9s  fresh (fetched %.0fs ago, tips unchanged)\n", repos[i].name, "ok", "-", ages[i]);
+    }
+    printf("\n%d fetched, %d fresh, %d failed, %.1f s total\n",
+           job_count - failed, fresh_count, failed, (now_ms() - start) / 1000.0);
+
+    pool_free(checks, check_count);
+    pool_free(jobs, job_count);
+    free(checks);
+    free(jobs);
+    free(fresh);
+    free(ages);
+    free(recent);
+    free(stale);
+    free(repos);
+    lazyprintf("Next: Returning to main menu");
+    pausef(NULL);
+}
+
+void workspace_commit_all(void) {
+    char msg[256];
+    char command[1024];
+
+    stats_set_flow("commit-all");
+    clear_screen();
+    printf("--- COMMIT ALL REPOSITORIES ---\n");
+    printf("Every repository with changes will be staged, committed and pushed.\n");
+    printf("Enter commit message (or press Enter to go back to menu):\n");
+    get_input_string(msg, sizeof(msg));
+
+    if (strlen(msg) == 0) {
+        printf("Aborted (empty message).\n");
+    } else {
+        snprintf(command, sizeof(command),
+                 "git add . && (git diff --cached --quiet && echo \"nothing to commit\" || "
+                 "(git commit -q -m \"%s\" && git push -q origin HEAD))", msg);
+        run_everywhere("COMMIT SUMMARY", command, commit_detail);
+    }
+    lazyprintf("Next: Returning to main menu");
+    pausef(NULL);
+}
+
+void workspace_status_all(void) {
+    stats_set_flow("status-all");
+    clear_screen();
+    printf("--- STATUS OF ALL REPOSITORIES ---\n");
+    run_everywhere("STATUS SUMMARY", "git status --porcelain --branch", status_detail);
+    lazyprintf("Next: Returning to main menu");
+    pausef(NULL);
+}
+
+/* --- SYNC --- */
+enum { SYNC_PENDING, SYNC_UPDATED, SYNC_CURRENT, SYNC_SKIPPED, SYNC_FAILED };
+
+typedef struct {
+    int state;
+    char branch[REF_NAME_MAX];
+    char remote[256];           /* branch.<b>.remote; "." for a local upstream */
+    char merge[REF_NAME_MAX];   /* branch.<b>.merge, e.g. "refs/heads/main" */
+    char tracking[REF_NAME_MAX]; /* where it is fetched to, e.g. "refs/remotes/origin/main" */
+    char detail[256];
+    double wall_ms;
+} sync_row;
+
+/* Reads the upstream of row->branch from the config in one process. Returns 1 if it has one. */
+static int resolve_upstream(sync_row *row) {
+    char line[1024];
+    if (!read_cmd_line(line, sizeof(line),
+                       "git for-each-ref --format=\"%%(upstream:remotename)%%09%%(upstream:remoteref)%%09%%(upstream)\" "
+                       "\"refs/heads/%s\"", row->branch)) return 0;
+    char *merge = strchr(line, '\t');
+    char *tracking = merge ? strchr(merge + 1, '\t') : NULL;
+    if (!tracking || merge == line || tracking == merge + 1) return 0;
+    *merge++ = '\0';
+    *tracking++ = '\0';
+    snprintf(row->remote, sizeof(row->remote), "%.*s", (int)sizeof(row->remote) - 1, line);
+    snprintf(row->merge, sizeof(row->merge), "%.*s", (int)sizeof(row->merge) - 1, merge);
+    snprintf(row->tracking, sizeof(row->tracking), "%.*s", (int)sizeof(row->tracking) - 1, tracking);
+    return 1;
+}
+
+/* Prepares one job (label and cwd) per repo still pending; job j belongs to repo index[j].
+ * Returns the job count (0 if none or out of memory); *jobs must be freed. */
+static int pending_jobs(const ws_repo *repos, const sync_row *rows, int repo_count, pool_job **jobs, int *index) {
+    *jobs = calloc(repo_count > 0 ? repo_count : 1, sizeof(pool_job));
+    if (!*jobs) return 0;
+    int n = 0;
+    for (int i = 0; i < repo_count; i++) {
+        if (rows[i].state != SYNC_PENDING) continue;
+        pool_job *job = &(*jobs)[n];
+        snprintf(job->label, sizeof(job->label), "%s", repos[i].name);
+        snprintf(job->cwd, sizeof(job->cwd), "%s", repos[i].path);
+        index[n++] = i;
+    }
+    return n;
+}
+
+int workspace_sync(void) {
+    stats_set_flow("sync");
+    ws_repo *repos = NULL;
+    int repo_count = workspace_load(&repos);
+    sync_row *rows = calloc(repo_count > 0 ? repo_count : 1, sizeof(sync_row));
+    int *index = calloc(repo_count > 0 ? repo_count : 1, sizeof(int));
+    if (repo_count == 0 || !rows || !index) {
+        if (repo_count == 0) printf("No repositories defined (%s or REPO_NAMES in .env).\n", MANIFEST_FILE);
+        free(rows);
+        free(index);
+        free(repos);
+        return 0;
+    }
+
+    /* 1. Current branch of every clone, read in-process, and its upstream */
+    for (int i = 0; i < repo_count; i++) {
+        sync_row *row = &rows[i];
+        if (!repos[i].exists) {
+            row->state = SYNC_SKIPPED;
+            snprintf(row->detail, sizeof(row->detail), "not cloned");
+        } else if (!enter_repo(repos[i].path)) {
+            row->state = SYNC_FAILED;
+            snprintf(row->detail, sizeof(row->detail), "cannot enter the directory");
+        } else {
+            if (!refs_head_branch(row->branch, sizeof(row->branch))) {
+                row->state = SYNC_SKIPPED;
+                snprintf(row->detail, sizeof(row->detail), "detached HEAD, not touched");
+            } else if (!resolve_upstream(row)) {
+                row->state = SYNC_SKIPPED;
+                snprintf(row->detail, sizeof(row->detail), "no upstream branch, not touched");
+            }
+            leave_repo();
+        }
+    }
+
+    int workers = pool_default_workers();
+    double start = now_ms();
+
+    /* 2. Fetch exactly the upstream of each checked-out branch, concurrently */
+    pool_job *jobs = NULL;
+    int job_count = pending_jobs(repos, rows, repo_count, &jobs, index);
+    for (int j = 0; j < job_count; j++) {
+        const sync_row *row = &rows[index[j]];
+        if (strcmp(row->remote, ".") == 0) {
+            /* Upstream is a local branch: nothing to fetch, just make sure it exists */
+            snprintf(jobs[j].command, sizeof(jobs[j].command), "git rev-parse -q --verify \"%s\"", row->tracking);
+        } else {
+            snprintf(jobs[j].command, sizeof(jobs[j].command), "git fetch --progress \"%s\" \"+%s:%s\"",
+                     row->remote, row->merge, row->tracking);
+        }
+        progress_log_path(jobs[j].label, "sync", jobs[j].log_path, sizeof(jobs[j].log_path));
+    }
+    progress_view view;
+    if (job_count > 0) printf("Syncing %d repositories with %d workers...\n", job_count, workers);
+    if (job_count > 0 && progress_init(&view, "Fetching", job_count) == 0) {
+        pool_run_observed(jobs, job_count, workers, progress_observe, &view);
+        progress_finish(&view, jobs, job_count);
+        progress_free(&view);
+    } else {
+        pool_run(jobs, job_count, workers);
+    }
+    for (int j = 0; j < job_count; j++) {
+        sync_row *row = &rows[index[j]];
+        row->wall_ms = jobs[j].wall_ms;
+        if (jobs[j].exit_code == 0) continue;
+        row->state = SYNC_FAILED;
+        last_line(jobs[j].output, row->detail, sizeof(row->detail));
+    }
+    pool_free(jobs, job_count);
+    free(jobs);
+
+    /* 3. Where each clone stands against its upstream; only clean, strictly behind ones move */
+    job_count = pending_jobs(repos, rows, repo_count, &jobs, index);
+    for (int j = 0; j < job_count; j++) {
+        snprintf(jobs[j].command, sizeof(jobs[j].command), "git status --porcelain --untracked-files=no --branch");
+    }
+    pool_run(jobs, job_count, workers);
+    for (int j = 0; j < job_count; j++) {
+        sync_row *row = &rows[index[j]];
+        status_info info;
+        parse_status(jobs[j].output, &info);
+        row->wall_ms += jobs[j].wall_ms;
+        if (jobs[j].exit_code != 0) {
+            row->state = SYNC_FAILED;
+            last_line(jobs[j].output, row->detail, sizeof(row->detail));
+        } else if (!info.upstream) {
+            row->state = SYNC_SKIPPED;
+            snprintf(row->detail, sizeof(row->detail), "no upstream branch, not touched");
+        } else if (info.behind == 0) {
+            row->state = SYNC_CURRENT;
+            if (info.ahead > 0) snprintf(row->detail, sizeof(row->detail), "up to date, %d local commit(s) to push", info.ahead);
+            else snprintf(row->detail, sizeof(row->detail), "up to date");
+        } else if (info.ahead > 0) {
+            row->state = SYNC_SKIPPED;
+            snprintf(row->detail, sizeof(row->detail), "diverged (+%d/-%d), not touched", info.ahead, info.behind);
+        } else if (info.changes > 0) {
+            row->state = SYNC_SKIPPED;
+            snprintf(row->detail, sizeof(row->detail), "behind %d but %d changed file(s), not touched",
+                     info.behind, info.changes);
+        } else {
+            snprintf(row->detail, sizeof(row->detail), "fast-forwarded %d commit(s)", info.behind);
+        }
+    }
+    pool_free(jobs, job_count);
+    free(jobs);
+
+    /* 4. Fast-forward the rest */
+    job_count = pending_jobs(repos, rows, repo_count, &jobs, index);
+    for (int j = 0; j < job_count; j++) {
+        snprintf(jobs[j].command, sizeof(jobs[j].command), "git merge --ff-only -q \"%s\"", rows[index[j]].tracking);
+    }
+    pool_run(jobs, job_count, workers);
+    for (int j = 0; j < job_count; j++) {
+        sync_row *row = &rows[index[j]];
+        row->wall_ms += jobs[j].wall_ms;
+        row->state = jobs[j].exit_code == 0 ? SYNC_UPDATED : SYNC_FAILED;
+        if (jobs[j].exit_code != 0) last_line(jobs[j].output, row->detail, sizeof(row->detail));
+    }
+    pool_free(jobs, job_count);
+    free(jobs);
+
+    static const char *RESULTS[] = { "-", "ok", "ok", "skip", "FAIL" };
+    int counts[5] = {0};
+    printf("\n=== SYNC SUMMARY ===\n\n");
+    printf("%-28s %-6s %9s  %s\n", "Repo", "Result", "Time(ms)", "Detail");
+    for (int i = 0; i < repo_count; i++) {
+        counts[rows[i].state]++;
+        printf("%-28s %-6s %9.0f  %s\n", repos[i].name, RESULTS[rows[i].state], rows[i].wall_ms, rows[i].detail);
+    }
+    printf("\n%d updated, %d up to date, %d not touched, %d failed, %.1f s total\n",
+           counts[SYNC_UPDATED], counts[SYNC_CURRENT], counts[SYNC_SKIPPED], counts[SYNC_FAILED],
+           (now_ms() - start) / 1000.0);
+
+    free(rows);
+    free(index);
+    free(repos);
+    return counts[SYNC_FAILED];
+}
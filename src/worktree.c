@@ -0,0 +1,121 @@
+/*
+ * Worktree Module
+ * ---------------
+ * Author: Jaehoon, 2025
+ *
+ * A new branch:      git worktree add -b <branch> <root>/<branch>        (from HEAD)
+ * A branch without:  git worktree add <root>/<branch> <branch>
+ * A branch with one: reused as is, wherever it lives
+ * Changes move with 'git stash push -u' here and 'git stash pop' there; the stash is shared by
+ * all worktrees of a repository. Slashes in branch names become '_' in directory names.
+ */
+
+#include "core.h"
+#include "worktree.h"
+#include "refs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* --- PATHS --- */
+/* WORKTREE_DIR, else '<main worktree>.worktrees' next to the main worktree.
+ * Returns 0 on success, -1 outside a repository or if the path does not fit. */
+static int worktree_root(char *root, size_t size) {
+    const char *env = getenv("WORKTREE_DIR");
+    int n;
+    if (env && env[0]) {
+        n = snprintf(root, size, "%s", env);
+        return n >= 0 && (size_t)n < size ? 0 : -1;
+    }
+    char common[1024], main_dir[1024];
+    if (!refs_common_dir(common, sizeof(common)) || absolute_path(common, main_dir, sizeof(main_dir)) != 0) return -1;
+    char *slash = strrchr(main_dir, '/');
+    if (!slash) slash = strrchr(main_dir, '\\');
+    if (!slash || slash == main_dir) return -1;
+    *slash = '\0'; /* strip '/.git' */
+    n = snprintf(root, size, "%s.worktrees", main_dir);
+    return n >= 0 && (size_t)n < size ? 0 : -1;
+}
+
+/* --- CHANGES --- */
+static int has_changes(void) {
+    FILE *fp = open_cmd("r", "git status --porcelain");
+    if (!fp) return 0;
+    int dirty = 0;
+    while (fgetc(fp) != EOF) dirty = 1; /* read it all, so git is not cut off mid-write */
+    close_cmd(fp);
+    return dirty;
+}
+
+static int move_changes(const char *branch, const char *dir) {
+    printf("Moving uncommitted changes to %s...\n", dir);
+    if (run_cmd("git stash push -u -q -m \"ydjs: moving changes to %s\"", branch) != 0) {
+        printf("Error: could not stash the changes; nothing was moved.\n");
+        return -1;
+    }
+    if (run_cmd("git -C \"%s\" stash pop -q", dir) != 0) {
+        printf("Error: the changes do not apply cleanly in %s; they are kept in 'git stash list'.\n", dir);
+        return -1;
+    }
+    return 0;
+}
+
+/* --- PUBLIC API --- */
+int worktree_mode(void) {
+    const char *env = getenv("PUSH_WORKTREES");
+    return env && strcmp(env, "1") == 0;
+}
+
+int worktree_enter(const char *branch, char *dir, size_t size) {
+    char current[REF_NAME_MAX], existing[1024];
+    if (refs_head_branch(current, sizeof(current)) && strcmp(current, branch) == 0) {
+        snprintf(dir, size, ".");
+        return 1;
+    }
+    int dirty = has_changes();
+
+    int found = refs_worktree_path(branch, existing, sizeof(existing));
+    if (found && ACCESS(existing) != 0) {
+        /* Its directory was deleted by hand: forget it, so the branch can get a new one */
+        run_cmd("git worktree prune");
+        found = 0;
+    }
+    if (found) {
+        if (absolute_path(existing, dir, size) != 0) return -1;
+        printf("Reusing the worktree of '%s' in %s\n", branch, dir);
+    } else {
+        char root[1024], name[REF_NAME_MAX + 16], oid[REF_OID_MAX];
+        if (worktree_root(root, sizeof(root)) != 0) {
+            printf("Error: could not resolve the worktree directory.\n");
+            return -1;
+        }
+        if (MAKE_DIR(root) != 0 && errno != EEXIST) {
+            printf("Error: could not create %s.\n", root);
+            return -1;
+        }
+        int n = snprintf(dir, size, "%s/%s", root, branch);
+        if (n < 0 || (size_t)n >= size) {
+            printf("Error: the worktree path for '%s' is too long.\n", branch);
+            return -1;
+        }
+        for (char *p = dir + strlen(root) + 1; *p; p++) {
+            if (*p == '/' || *p == '\\') *p = '_';
+        }
+
+        ref_index heads;
+        int exists = 0;
+        if (ref_index_open(&heads, "refs/heads/") == 0) {
+            snprintf(name, sizeof(name), "refs/heads/%s", branch);
+            exists = ref_index_lookup(&heads, name, oid, sizeof(oid));
+            ref_index_close(&heads);
+        }
+        int rc = exists ? run_cmd("git worktree add -q \"%s\" \"%s\"", dir, branch)
+                        : run_cmd("git worktree add -q -b \"%s\" \"%s\"", branch, dir);
+        if (rc != 0) return -1;
+        printf("Created a worktree for '%s' in %s\n", branch, dir);
+    }
+
+    if (dirty && move_changes(branch, dir) != 0) return -1;
+    return 0;
+}